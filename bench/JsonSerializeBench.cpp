@@ -0,0 +1,100 @@
+// Microbenchmark: Reservation -> JSON for GET responses.
+// Compares the boost::json::object + serialize path reservationToJson used
+// to take with the direct writer into a reused buffer.
+// Build and run with: make bench
+
+#include <boost/json.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "../src/HTTP/JsonHandler.hpp"
+
+namespace {
+
+constexpr int kIterations = 200000;
+
+Reservation sampleReservation() {
+    Reservation res;
+    res.guest_name = "Juan Perez";
+    res.guest_email = "juan@example.com";
+    res.guest_phone = "+34 123 456 789";
+    res.room_number = 101;
+    res.room_type = "Double";
+    res.number_of_guests = 2;
+    res.check_in_date = "2026-02-15";
+    res.check_out_date = "2026-02-20";
+    res.number_of_nights = 5;
+    res.price_per_night = 150.50;
+    res.total_price = 752.50;
+    res.payment_method = "credit_card";
+    res.paid = true;
+    res.reservation_status = "confirmed";
+    res.special_requests = "Late check-in, \"quiet\" room";
+    res.created_at = 1707124800;
+    res.updated_at = 1707124800;
+    return res;
+}
+
+std::string serializeWithDom(const Reservation& res) {
+    boost::json::object jsonObj;
+    jsonObj["guest_name"] = res.guest_name;
+    jsonObj["guest_email"] = res.guest_email;
+    jsonObj["guest_phone"] = res.guest_phone;
+    jsonObj["room_number"] = res.room_number;
+    jsonObj["room_type"] = res.room_type;
+    jsonObj["number_of_guests"] = res.number_of_guests;
+    jsonObj["check_in_date"] = res.check_in_date;
+    jsonObj["check_out_date"] = res.check_out_date;
+    jsonObj["number_of_nights"] = res.number_of_nights;
+    jsonObj["price_per_night"] = res.price_per_night;
+    jsonObj["total_price"] = res.total_price;
+    jsonObj["payment_method"] = res.payment_method;
+    jsonObj["paid"] = res.paid;
+    jsonObj["reservation_status"] = res.reservation_status;
+    jsonObj["special_requests"] = res.special_requests;
+    jsonObj["created_at"] = res.created_at;
+    jsonObj["updated_at"] = res.updated_at;
+    return boost::json::serialize(jsonObj);
+}
+
+template <typename Function>
+double nanosecondsPerCall(Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; i++) {
+        function();
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kIterations;
+}
+
+}  // namespace
+
+int main() {
+    JsonHandler jsonHandler;
+    Reservation res = sampleReservation();
+    std::string buffer;
+    std::size_t bytes = 0;
+
+    if (jsonHandler.reservationToJson(res) != serializeWithDom(res)) {
+        std::cerr << "reservationToJson output differs from serialize()\n";
+        return 1;
+    }
+
+    double dom = nanosecondsPerCall([&]() {
+        bytes += serializeWithDom(res).size();
+    });
+    double direct = nanosecondsPerCall([&]() {
+        jsonHandler.reservationToJson(res, buffer);
+        bytes += buffer.size();
+    });
+
+    std::cout << "JsonSerializeBench (" << kIterations << " iterations)\n"
+              << "  boost::json::object + serialize: " << dom << " ns/op\n"
+              << "  reservationToJson(res, buffer):  " << direct
+              << " ns/op\n"
+              << "  speedup: " << dom / direct << "x\n";
+    // Keeps the loops from being optimized away
+    return bytes == 0 ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+// Benchmark: reading a batch of reservations one statement at a time, each
+// waiting its round trip, against PostgresDB::getReservationsById, which
+// sends them all through one libpq pipeline. The gap grows with the
+// latency to the server. Needs the database configured in .env; skipped
+// without it. Build and run with: make bench
+
+#include <chrono>
+#include <iostream>
+#include <pqxx/pqxx>
+#include <vector>
+
+#include "../src/DataBase/PostgresDB.hpp"
+#include "../src/config/ConfigManager.hpp"
+
+namespace {
+
+constexpr int kBatch = 200;
+constexpr int kRounds = 20;
+
+Reservation benchReservation() {
+    Reservation res;
+    res.guest_name = "BENCH_OWNER";
+    res.guest_email = "bench@example.com";
+    res.guest_phone = "+34 123 456 789";
+    res.room_number = 998;
+    res.room_type = "Double";
+    res.number_of_guests = 2;
+    res.check_in_date = "2099-01-01";
+    res.check_out_date = "2099-01-02";
+    res.number_of_nights = 1;
+    res.price_per_night = 100.0;
+    res.total_price = 100.0;
+    res.payment_method = "credit_card";
+    res.paid = true;
+    res.reservation_status = "confirmed";
+    res.created_at = 4070908800;
+    res.updated_at = 4070908800;
+    return res;
+}
+
+template <typename Function>
+double microsecondsPerBatch(Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRounds; i++) {
+        function();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kRounds;
+}
+
+}  // namespace
+
+int main() {
+    try {
+        ConfigManager config(".env");
+        PostgresDB db(config);
+        auto conn = db.getConnectionPool()->acquire();
+
+        int id = db.insertReservation(*conn, benchReservation());
+        if (id == -1) {
+            std::cerr << "PipelineBench: could not insert the benchmark "
+                         "reservation\n";
+            return 1;
+        }
+        std::vector<int> ids(kBatch, id);
+
+        std::size_t rows = 0;
+        double sequential = microsecondsPerBatch([&]() {
+            for (int batchId : ids) {
+                rows += db.getReservationById(*conn, batchId).room_number > 0;
+            }
+        });
+        double pipelined = microsecondsPerBatch([&]() {
+            for (const auto& res : db.getReservationsById(*conn, ids)) {
+                rows += res.has_value();
+            }
+        });
+        db.deleteReservation(*conn, id);
+
+        std::cout << "PipelineBench (" << kRounds << " batches of " << kBatch
+                  << " reads)\n"
+                  << "  one round trip per read: " << sequential
+                  << " us/batch\n"
+                  << "  pipelined:               " << pipelined
+                  << " us/batch\n"
+                  << "  speedup: " << sequential / pipelined << "x\n";
+        return rows == 0 ? 1 : 0;
+    } catch (const std::exception& e) {
+        // A benchmark run without a database is not a failure
+        std::cout << "PipelineBench skipped: " << e.what() << "\n";
+        return 0;
+    }
+}
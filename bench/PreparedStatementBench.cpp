@@ -0,0 +1,106 @@
+// Benchmark: GET /application/reservation/{id} query against PostgreSQL.
+// Compares sending the SQL text on every call, which PostgreSQL parses and
+// plans each time, with the statement PostgresDB prepares once per
+// connection. Needs the database configured in .env; skipped without it.
+// Build and run with: make bench
+
+#include <chrono>
+#include <iostream>
+#include <pqxx/pqxx>
+#include <string>
+
+#include "../src/DataBase/PostgresDB.hpp"
+#include "../src/config/ConfigManager.hpp"
+
+namespace {
+
+constexpr int kIterations = 5000;
+
+// Same text as the statement PostgresDB prepares
+constexpr const char* kSelectSql = R"(
+    SELECT guest_name, guest_email, guest_phone,
+           room_number, room_type, number_of_guests,
+           check_in_date, check_out_date, number_of_nights,
+           price_per_night, total_price, payment_method, paid,
+           reservation_status, special_requests,
+           created_at, updated_at
+    FROM reservations
+    WHERE id = $1
+)";
+
+Reservation benchReservation() {
+    Reservation res;
+    res.guest_name = "BENCH_OWNER";
+    res.guest_email = "bench@example.com";
+    res.guest_phone = "+34 123 456 789";
+    res.room_number = 999;
+    res.room_type = "Double";
+    res.number_of_guests = 2;
+    res.check_in_date = "2099-01-01";
+    res.check_out_date = "2099-01-02";
+    res.number_of_nights = 1;
+    res.price_per_night = 100.0;
+    res.total_price = 100.0;
+    res.payment_method = "credit_card";
+    res.paid = true;
+    res.reservation_status = "confirmed";
+    res.created_at = 4070908800;
+    res.updated_at = 4070908800;
+    return res;
+}
+
+// Unprepared equivalent of PostgresDB::getReservationById
+std::string selectWithText(pqxx::connection& conn, int id) {
+    pqxx::nontransaction txn(conn);
+    pqxx::params p;
+    p.append(id);
+    auto result = txn.exec(kSelectSql, p);
+    return result[0][0].as<std::string>();
+}
+
+template <typename Function>
+double microsecondsPerCall(Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; i++) {
+        function();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kIterations;
+}
+
+}  // namespace
+
+int main() {
+    try {
+        ConfigManager config(".env");
+        PostgresDB db(config);
+        auto conn = db.getConnectionPool()->acquire();
+
+        int id = db.insertReservation(*conn, benchReservation());
+        if (id == -1) {
+            std::cerr << "PreparedStatementBench: could not insert the "
+                         "benchmark reservation\n";
+            return 1;
+        }
+
+        std::size_t bytes = 0;
+        double text = microsecondsPerCall(
+            [&]() { bytes += selectWithText(*conn, id).size(); });
+        double prepared = microsecondsPerCall([&]() {
+            bytes += db.getReservationById(*conn, id).guest_name.size();
+        });
+        db.deleteReservation(*conn, id);
+
+        std::cout << "PreparedStatementBench (" << kIterations
+                  << " iterations)\n"
+                  << "  SQL text every call:  " << text << " us/op\n"
+                  << "  prepared statement:   " << prepared << " us/op\n"
+                  << "  speedup: " << text / prepared << "x\n";
+        return bytes == 0 ? 1 : 0;
+    } catch (const std::exception& e) {
+        // A benchmark run without a database is not a failure
+        std::cout << "PreparedStatementBench skipped: " << e.what() << "\n";
+        return 0;
+    }
+}
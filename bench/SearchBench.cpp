@@ -0,0 +1,205 @@
+// Benchmark: GET /application/reservations and the availability check on a
+// table of 10M reservations, through the indexes PostgresDB::ensureIndexes
+// creates, against the same queries run as full table scans (index scans
+// disabled for the session).
+//
+// The rows live in their own schema, search_bench, with a copy of the
+// reservations table: the real table is left alone. Seeding takes a while,
+// so the schema is kept for the next run; drop it with
+// "DROP SCHEMA search_bench CASCADE". SEARCH_BENCH_ROWS overrides the row
+// count. Needs the database configured in .env; skipped without it.
+// Build and run with: make bench
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <pqxx/pqxx>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "../src/DataBase/PostgresDB.hpp"
+#include "../src/config/ConfigManager.hpp"
+
+namespace {
+
+constexpr long kDefaultRows = 10'000'000;
+// Rows per INSERT while seeding
+constexpr long kSeedChunk = 1'000'000;
+// Each room gets back to back stays of kStayDays, kStayDays apart from the
+// previous check-in, so no two of them overlap
+constexpr long kRooms = 5000;
+constexpr long kStayDays = 4;
+constexpr int kIndexedRounds = 200;
+constexpr int kScanRounds = 3;
+
+// Rows g = $1 .. $2 - 1, with ID g + 1: room g % kRooms ($3), stay
+// g / kRooms, one in ten cancelled and one in ten pending
+constexpr const char* kSeedSql = R"(
+    INSERT INTO reservations (
+        id, guest_name, guest_email, guest_phone,
+        room_number, room_type, number_of_guests,
+        check_in_date, check_out_date, number_of_nights,
+        price_per_night, total_price, payment_method, paid,
+        reservation_status, special_requests,
+        created_at, updated_at
+    )
+    SELECT g + 1, 'BENCH_SEARCH', 'bench@example.com', '+34 123 456 789',
+           g % $3 + 1, 'Double', 2,
+           date '2000-01-01' + (g / $3 * $4)::int,
+           date '2000-01-01' + (g / $3 * $4 + $4 - 2)::int, $4 - 2,
+           100.0, 100.0 * ($4 - 2), 'credit_card', true,
+           CASE g % 10 WHEN 0 THEN 'cancelled' WHEN 1 THEN 'pending'
+                ELSE 'confirmed' END,
+           '', 946684800, 946684800
+    FROM generate_series($1::bigint, $2::bigint - 1) AS g
+)";
+
+std::string benchConnectionString(const ConfigManager& config) {
+    std::ostringstream oss;
+    oss << "host=" << config.get("DB_HOST")
+        << " port=" << config.getInt("DB_PORT")
+        << " dbname=" << config.get("DB_NAME")
+        << " user=" << config.get("DB_USER")
+        << " password=" << config.get("DB_PASSWORD")
+        << " options='-c search_path=search_bench'";
+    return oss.str();
+}
+
+// Creates search_bench.reservations and fills it up to rows rows
+void seed(pqxx::connection& conn, long rows) {
+    {
+        pqxx::work txn(conn);
+        txn.exec("CREATE SCHEMA IF NOT EXISTS search_bench");
+        txn.exec(
+            "CREATE TABLE IF NOT EXISTS search_bench.reservations "
+            "(LIKE public.reservations INCLUDING ALL)");
+        txn.commit();
+    }
+    long present = 0;
+    {
+        pqxx::work txn(conn);
+        present = txn.exec("SELECT count(*) FROM reservations")[0][0]
+                      .as<long>();
+        txn.commit();
+    }
+    for (long first = present; first < rows; first += kSeedChunk) {
+        long last = std::min(first + kSeedChunk, rows);
+        pqxx::work txn(conn);
+        pqxx::params p;
+        p.append(first);
+        p.append(last);
+        p.append(kRooms);
+        p.append(kStayDays);
+        txn.exec(kSeedSql, p);
+        txn.commit();
+        std::cout << "  seeded " << last << " / " << rows << " rows\n";
+    }
+    if (present < rows) {
+        pqxx::nontransaction txn(conn);
+        txn.exec("ANALYZE reservations");
+    }
+}
+
+template <typename Function>
+double microsecondsPerCall(int rounds, Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        function();
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+std::string dayOffset(long days) {
+    auto day = std::chrono::sys_days(std::chrono::year(2000) /
+                                     std::chrono::January / 1) +
+               std::chrono::days(days);
+    std::chrono::year_month_day date(day);
+    char text[11];
+    std::snprintf(text, sizeof(text), "%04d-%02u-%02u",
+                  static_cast<int>(date.year()),
+                  static_cast<unsigned>(date.month()),
+                  static_cast<unsigned>(date.day()));
+    return text;
+}
+
+}  // namespace
+
+int main() {
+    try {
+        ConfigManager config(".env");
+        PostgresDB db(config);
+        long rows = kDefaultRows;
+        if (const char* setting = std::getenv("SEARCH_BENCH_ROWS")) {
+            rows = std::stol(setting);
+        }
+
+        pqxx::connection conn(benchConnectionString(config));
+        std::cout << "SearchBench (" << rows << " reservations)\n";
+        seed(conn, rows);
+        PostgresDB::prepareStatements(conn);
+        PostgresDB::ensureIndexes(conn);
+
+        long days = rows / kRooms * kStayDays;
+        std::mt19937 random(42);
+        std::uniform_int_distribution<long> anyRoom(1, kRooms);
+        std::uniform_int_distribution<long> anyDay(0, days - 30);
+        std::size_t found = 0;
+
+        auto byRoom = [&]() {
+            ReservationSearch search;
+            search.roomNumber = static_cast<int>(anyRoom(random));
+            long day = anyDay(random);
+            search.from = dayOffset(day);
+            search.to = dayOffset(day + 30);
+            found += db.searchReservations(conn, search).size();
+        };
+        auto byStatus = [&]() {
+            ReservationSearch search;
+            search.status = "pending";
+            long day = anyDay(random);
+            search.from = dayOffset(day);
+            search.to = dayOffset(day + 7);
+            found += db.searchReservations(conn, search).size();
+        };
+        auto availability = [&]() {
+            long day = anyDay(random);
+            found += db.overlappingReservations(
+                           conn, static_cast<int>(anyRoom(random)),
+                           dayOffset(day), dayOffset(day + 3))
+                         .size();
+        };
+
+        double roomIndexed = microsecondsPerCall(kIndexedRounds, byRoom);
+        double statusIndexed = microsecondsPerCall(kIndexedRounds, byStatus);
+        double availableIndexed =
+            microsecondsPerCall(kIndexedRounds, availability);
+        {
+            pqxx::nontransaction txn(conn);
+            txn.exec("SET enable_indexscan = off");
+            txn.exec("SET enable_bitmapscan = off");
+            txn.exec("SET enable_indexonlyscan = off");
+        }
+        double roomScan = microsecondsPerCall(kScanRounds, byRoom);
+        double statusScan = microsecondsPerCall(kScanRounds, byStatus);
+        double availableScan = microsecondsPerCall(kScanRounds, availability);
+
+        auto report = [](const char* name, double indexed, double scan) {
+            std::cout << "  " << name << ": " << indexed
+                      << " us indexed, " << scan << " us table scan ("
+                      << scan / indexed << "x)\n";
+        };
+        report("room + 30 days  ", roomIndexed, roomScan);
+        report("status + 7 days ", statusIndexed, statusScan);
+        report("availability    ", availableIndexed, availableScan);
+        return found == 0 ? 1 : 0;
+    } catch (const std::exception& e) {
+        // A benchmark run without a database is not a failure
+        std::cout << "SearchBench skipped: " << e.what() << "\n";
+        return 0;
+    }
+}
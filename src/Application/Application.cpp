@@ -7,7 +7,8 @@ Application::Application(const std::string& configPath, int recvPort)
     try {
         configManager = std::make_unique<ConfigManager>(configPath);
         database = std::make_unique<PostgresDB>(*configManager);
-        httpServer = std::make_unique<HttpServer>(database.get(), port);
+        httpServer = std::make_unique<HttpServer>(
+            database.get(), port, ServerOptions::fromConfig(*configManager));
         signalManager = std::make_unique<SignalManager>();
     } catch (const std::exception& e) {
         throw std::runtime_error(
@@ -0,0 +1,107 @@
+#include "AsyncConnection.hpp"
+
+#include <unistd.h>
+
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace asio = boost::asio;
+
+AsyncConnection::AsyncConnection(asio::any_io_executor executor,
+                                 pqxx::connection& conn_param)
+    : conn(conn_param), socket(executor) {
+    if (!conn.is_open()) {
+        throw std::runtime_error("Connection lost");
+    }
+    raw = std::move(conn).release_raw_connection();
+    if (PQsetnonblocking(raw, 1) != 0) {
+        std::string error = PQerrorMessage(raw);
+        restore();
+        throw std::runtime_error("Cannot enter non-blocking mode: " + error);
+    }
+    int fd = ::dup(PQsocket(raw));
+    if (fd < 0) {
+        restore();
+        throw std::runtime_error("Cannot watch the connection socket");
+    }
+    socket.assign(fd);
+}
+
+AsyncConnection::~AsyncConnection() {
+    boost::system::error_code ec;
+    socket.close(ec);
+    restore();
+    if (busy) {
+        std::cerr << "[AsyncConnection] Statement interrupted, closing the "
+                     "connection"
+                  << std::endl;
+        conn.close();
+    }
+}
+
+void AsyncConnection::restore() {
+    PQsetnonblocking(raw, 0);
+    conn = pqxx::connection::seize_raw_connection(raw);
+}
+
+asio::awaitable<AsyncConnection::Result> AsyncConnection::execPrepared(
+    const char* statement, std::vector<std::string> params) {
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const std::string& param : params) {
+        values.push_back(param.c_str());
+    }
+    if (PQsendQueryPrepared(raw, statement, static_cast<int>(values.size()),
+                            values.data(), nullptr, nullptr, 0) != 1) {
+        fail("Cannot send statement");
+    }
+    busy = true;
+
+    // In non-blocking mode the statement may stay partly buffered until
+    // the socket accepts it. As libpq requires, wait for the socket to be
+    // writable or readable, and read whatever arrived: a server blocked
+    // sending to us (notices, earlier results) stops reading what we send.
+    using namespace asio::experimental::awaitable_operators;
+    using Descriptor = asio::posix::stream_descriptor;
+    int flushed;
+    while ((flushed = PQflush(raw)) == 1) {
+        auto ready = co_await (
+            socket.async_wait(Descriptor::wait_read, asio::use_awaitable) ||
+            socket.async_wait(Descriptor::wait_write, asio::use_awaitable));
+        if (ready.index() == 0 && PQconsumeInput(raw) != 1) {
+            fail("Connection lost");
+        }
+    }
+    if (flushed != 0) {
+        fail("Cannot send statement");
+    }
+
+    // One statement gives one result, then nullptr once it is complete
+    Result result;
+    while (true) {
+        if (PQconsumeInput(raw) != 1) {
+            fail("Connection lost");
+        }
+        while (PQisBusy(raw) == 0) {
+            Result next(PQgetResult(raw));
+            if (!next) {
+                busy = false;
+                if (!result) {
+                    fail("Missing result");
+                }
+                co_return result;
+            }
+            if (!result) {
+                result = std::move(next);
+            }
+        }
+        co_await socket.async_wait(asio::posix::stream_descriptor::wait_read,
+                                   asio::use_awaitable);
+    }
+}
+
+void AsyncConnection::fail(const std::string& what) const {
+    throw std::runtime_error(what + ": " + PQerrorMessage(raw));
+}
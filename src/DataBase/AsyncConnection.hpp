@@ -0,0 +1,75 @@
+#ifndef ASYNCCONNECTION_HPP
+#define ASYNCCONNECTION_HPP
+
+#include <libpq-fe.h>
+
+#include <boost/asio.hpp>
+#include <pqxx/pqxx>
+#include <string>
+#include <vector>
+
+#include "PipelinedConnection.hpp"
+
+/*
+ * AsyncConnection.hpp
+ *
+ * A pool connection driven by libpq's non-blocking API from an asio
+ * executor. A statement is sent with PQsendQueryPrepared, and the
+ * coroutine then waits for the socket to become readable, registered with
+ * the io_context, instead of blocking its thread in the round trip. One
+ * io thread can so keep a statement in flight on every pool connection.
+ *
+ * As PipelinedConnection does, it takes the raw libpq handle out of the
+ * pqxx::connection for its lifetime and puts it back when destroyed; the
+ * statements prepared on the connection stay usable.
+ */
+class AsyncConnection {
+   public:
+    using Result = PipelinedConnection::Result;
+
+    /**
+     * Switch conn to non-blocking mode and register its socket
+     *
+     * param: executor - where the socket waits complete
+     * param: conn - open connection, e.g. from a ConnectionPool lease; it
+     *        must not be used directly until this object is destroyed
+     * throws: std::runtime_error if conn is closed or cannot be set up
+     */
+    AsyncConnection(boost::asio::any_io_executor executor,
+                    pqxx::connection& conn);
+
+    /**
+     * Give the handle back to conn in blocking mode. If a statement was
+     * left half way (its coroutine was destroyed), the session state is
+     * unknown and the connection is closed, so the pool reconnects it.
+     */
+    ~AsyncConnection();
+
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+
+    /**
+     * Execute a prepared statement, suspending while the server works
+     *
+     * param: statement - name given to pqxx::connection::prepare
+     * param: params - parameters in text format
+     * return: its result; check PQresultStatus(), PGRES_FATAL_ERROR for a
+     *         statement the server rejected
+     * throws: std::runtime_error if the connection fails
+     */
+    boost::asio::awaitable<Result> execPrepared(
+        const char* statement, std::vector<std::string> params);
+
+   private:
+    pqxx::connection& conn;
+    PGconn* raw = nullptr;
+    // Watches a duplicate of the libpq socket: closing it leaves libpq's
+    // own descriptor open
+    boost::asio::posix::stream_descriptor socket;
+    bool busy = false;
+
+    void restore();
+    [[noreturn]] void fail(const std::string& what) const;
+};
+
+#endif
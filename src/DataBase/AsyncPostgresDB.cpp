@@ -0,0 +1,121 @@
+#include "AsyncPostgresDB.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+#include "ReservationParams.hpp"
+
+namespace asio = boost::asio;
+
+namespace {
+
+// Parameter $1 of the get and delete statements. Built outside the
+// coroutines: GCC 12 rejects a braced list in a coroutine argument.
+std::vector<std::string> idParams(int id) { return {pqxx::to_string(id)}; }
+
+// Rows an UPDATE or DELETE touched, from a successful result
+bool changedRows(PGresult* result) {
+    return PQresultStatus(result) == PGRES_COMMAND_OK &&
+           std::string_view(PQcmdTuples(result)) != "0";
+}
+
+}  // namespace
+
+AsyncPostgresDB::AsyncPostgresDB(PostgresDB& database,
+                                 asio::any_io_executor executor_param)
+    : db(database), executor(std::move(executor_param)) {}
+
+asio::awaitable<ConnectionPool::Lease> AsyncPostgresDB::lease() {
+    ConnectionPool* pool = db.getConnectionPool();
+    auto deadline = std::chrono::steady_clock::now() + pool->acquireTimeout();
+    auto backoff = kMinBackoff;
+    asio::steady_timer timer(co_await asio::this_coro::executor);
+    while (true) {
+        if (auto conn = pool->tryAcquire()) {
+            co_return std::move(*conn);
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            throw PoolUnavailable(
+                "Timed out after " +
+                std::to_string(pool->acquireTimeout().count()) +
+                " ms waiting for a database connection");
+        }
+        timer.expires_after(std::min<std::chrono::steady_clock::duration>(
+            backoff, deadline - now));
+        co_await timer.async_wait(asio::use_awaitable);
+        backoff = std::min(backoff * 2, kMaxBackoff);
+    }
+}
+
+asio::awaitable<AsyncConnection::Result> AsyncPostgresDB::exec(
+    const char* statement, std::vector<std::string> params) {
+    ConnectionPool::Lease conn = co_await lease();
+    AsyncConnection async(co_await asio::this_coro::executor, *conn);
+    co_return co_await async.execPrepared(statement, std::move(params));
+}
+
+asio::awaitable<int> AsyncPostgresDB::insertReservation(Reservation res) {
+    std::string error;
+    try {
+        auto result =
+            co_await exec(PostgresDB::kInsertReservation, insertParams(res));
+        if (PQresultStatus(result.get()) == PGRES_TUPLES_OK &&
+            PQntuples(result.get()) == 1) {
+            co_return pqxx::from_string<int>(PQgetvalue(result.get(), 0, 0));
+        }
+        error = PQresultErrorMessage(result.get());
+    } catch (const PoolUnavailable&) {
+        throw;
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    std::cerr << "[AsyncPostgresDB] Error inserting reservation: " << error
+              << std::endl;
+    co_return -1;
+}
+
+asio::awaitable<Reservation> AsyncPostgresDB::getReservationById(int id) {
+    auto result = co_await exec(PostgresDB::kGetReservation, idParams(id));
+    if (PQresultStatus(result.get()) != PGRES_TUPLES_OK) {
+        throw std::runtime_error(
+            std::string("Error retrieving reservation: ") +
+            PQresultErrorMessage(result.get()));
+    }
+    if (PQntuples(result.get()) == 0) {
+        throw ReservationNotFound("Reservation with ID " +
+                                  std::to_string(id) + " not found");
+    }
+    co_return reservationFromResult(result.get());
+}
+
+asio::awaitable<bool> AsyncPostgresDB::updateReservation(int id,
+                                                         Reservation res) {
+    try {
+        auto result = co_await exec(PostgresDB::kUpdateReservation,
+                                    updateParams(id, res));
+        co_return changedRows(result.get());
+    } catch (const PoolUnavailable&) {
+        throw;
+    } catch (const std::exception& e) {
+        std::cerr << "[AsyncPostgresDB] Error updating reservation: "
+                  << e.what() << std::endl;
+    }
+    co_return false;
+}
+
+asio::awaitable<bool> AsyncPostgresDB::deleteReservation(int id) {
+    try {
+        auto result =
+            co_await exec(PostgresDB::kDeleteReservation, idParams(id));
+        co_return changedRows(result.get());
+    } catch (const PoolUnavailable&) {
+        throw;
+    } catch (const std::exception& e) {
+        std::cerr << "[AsyncPostgresDB] Error deleting reservation: "
+                  << e.what() << std::endl;
+    }
+    co_return false;
+}
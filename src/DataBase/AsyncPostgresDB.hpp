@@ -0,0 +1,100 @@
+#ifndef ASYNCPOSTGRESDB_HPP
+#define ASYNCPOSTGRESDB_HPP
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AsyncConnection.hpp"
+#include "PostgresDB.hpp"
+
+/*
+ * AsyncPostgresDB.hpp
+ *
+ * Asynchronous insert, get, update and delete on the PostgresDB pool. The
+ * operations never block their thread: the connection lease is retried on
+ * a timer while the pool is exhausted, and the statement runs on an
+ * AsyncConnection, so a single io thread can keep a query in flight on
+ * every pool connection at once.
+ *
+ * Each operation exists in two forms:
+ * - an awaitable, for coroutines: co_await db.getReservationById(id)
+ * - a completion token one, for anything else:
+ *   db.asyncGetReservationById(id, asio::use_future), or a callback taking
+ *   (std::exception_ptr, result)
+ *
+ * The contracts are those of the PostgresDB operations, except that
+ * PoolUnavailable always reaches the caller.
+ *
+ * Opening a connection (pool growth or reconnect) and the ping of a stale
+ * one still block, as in ConnectionPool::acquire().
+ */
+class AsyncPostgresDB {
+   public:
+    /**
+     * param: database - owns the pool; must outlive this object
+     * param: executor - runs the operations started with a completion
+     *        token
+     */
+    AsyncPostgresDB(PostgresDB& database,
+                    boost::asio::any_io_executor executor);
+
+    // return: ID of the inserted reservation, -1 if it was rejected
+    boost::asio::awaitable<int> insertReservation(Reservation res);
+
+    // throws: ReservationNotFound if no reservation with that ID exists
+    boost::asio::awaitable<Reservation> getReservationById(int id);
+
+    // return: true if a reservation was updated
+    boost::asio::awaitable<bool> updateReservation(int id, Reservation res);
+
+    // return: true if a reservation was deleted
+    boost::asio::awaitable<bool> deleteReservation(int id);
+
+    template <typename CompletionToken>
+    auto asyncInsertReservation(Reservation res, CompletionToken&& token) {
+        return boost::asio::co_spawn(executor,
+                                     insertReservation(std::move(res)),
+                                     std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto asyncGetReservationById(int id, CompletionToken&& token) {
+        return boost::asio::co_spawn(executor, getReservationById(id),
+                                     std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto asyncUpdateReservation(int id, Reservation res,
+                                CompletionToken&& token) {
+        return boost::asio::co_spawn(executor,
+                                     updateReservation(id, std::move(res)),
+                                     std::forward<CompletionToken>(token));
+    }
+
+    template <typename CompletionToken>
+    auto asyncDeleteReservation(int id, CompletionToken&& token) {
+        return boost::asio::co_spawn(executor, deleteReservation(id),
+                                     std::forward<CompletionToken>(token));
+    }
+
+   private:
+    // Retry interval while the pool is exhausted, doubled on every attempt
+    static constexpr std::chrono::microseconds kMinBackoff{100};
+    static constexpr std::chrono::microseconds kMaxBackoff{5000};
+
+    PostgresDB& db;
+    boost::asio::any_io_executor executor;
+
+    // Waits for a pool connection on a timer instead of a condition
+    // variable; throws PoolUnavailable after the pool's acquire timeout
+    boost::asio::awaitable<ConnectionPool::Lease> lease();
+
+    // Runs a prepared statement on a leased connection
+    boost::asio::awaitable<AsyncConnection::Result> exec(
+        const char* statement, std::vector<std::string> params);
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "BulkLoader.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+#include "PostgresDB.hpp"
+
+namespace {
+
+pqxx::stream_to openStream(pqxx::work& txn) {
+    return pqxx::stream_to::table(
+        txn, {"reservations"},
+        {"id", "guest_name", "guest_email", "guest_phone", "room_number",
+         "room_type", "number_of_guests", "check_in_date", "check_out_date",
+         "number_of_nights", "price_per_night", "total_price",
+         "payment_method", "paid", "reservation_status", "special_requests",
+         "created_at", "updated_at"});
+}
+
+void writeRow(pqxx::stream_to& stream, int id, const Reservation& res) {
+    stream.write_values(
+        id, res.guest_name, res.guest_email, res.guest_phone,
+        res.room_number, res.room_type, res.number_of_guests,
+        res.check_in_date, res.check_out_date, res.number_of_nights,
+        res.price_per_night, res.total_price, res.payment_method, res.paid,
+        res.reservation_status, res.special_requests, res.created_at,
+        res.updated_at);
+}
+
+// First line of the server's message, without its "ERROR:" tag: the
+// DETAIL and CONTEXT lines after it quote the row back
+std::string errorLine(const pqxx::sql_error& e) {
+    std::string_view text = e.what();
+    text = text.substr(0, text.find('\n'));
+    if (text.substr(0, 6) == "ERROR:") {
+        text.remove_prefix(6);
+    }
+    std::size_t start = text.find_first_not_of(' ');
+    return std::string(start == std::string_view::npos ? std::string_view()
+                                                       : text.substr(start));
+}
+
+}  // namespace
+
+BulkLoader::BulkLoader(pqxx::connection& conn_param, std::size_t maxRows)
+    : conn(conn_param), unreserved(maxRows) {
+    chunk.reserve(std::min(maxRows, kChunkRows));
+}
+
+void BulkLoader::add(std::size_t line, const Reservation& res) {
+    if (chunk.empty()) {
+        startChunk();
+    }
+    chunk.emplace_back(line, res);
+    if (!chunkFailed) {
+        try {
+            writeRow(*stream, chunkIds[chunk.size() - 1], res);
+        } catch (const pqxx::sql_error&) {
+            // The rest of the chunk is only kept, for loadOneByOne()
+            chunkFailed = true;
+        }
+    }
+    if (chunk.size() == chunkIds.size()) {
+        endChunk();
+    }
+}
+
+void BulkLoader::finish() {
+    if (!chunk.empty()) {
+        endChunk();
+    }
+    std::cout << "[BulkLoader] Loaded " << insertedRows << " reservations, "
+              << rejectedRows.size() << " refused" << std::endl;
+}
+
+void BulkLoader::startChunk() {
+    std::size_t rows = std::min(unreserved, kChunkRows);
+    if (rows == 0) {
+        throw std::logic_error("BulkLoader: more rows than announced");
+    }
+    txn.emplace(conn);
+    // IDs drawn for rows that fail are skipped, not reused
+    chunkIds = PostgresDB::drawReservationIds(*txn, rows);
+    unreserved -= rows;
+    // COPY sends the rows as one data stream: no per-row statement, round
+    // trip or commit
+    stream.emplace(openStream(*txn));
+}
+
+void BulkLoader::endChunk() {
+    if (!chunkFailed) {
+        try {
+            stream->complete();
+            txn->commit();
+            for (std::size_t i = 0; i < chunk.size(); i++) {
+                noteInserted(chunkIds[i]);
+            }
+            insertedRows += chunk.size();
+        } catch (const pqxx::sql_error& e) {
+            std::cerr << "[BulkLoader] Chunk refused, loading its "
+                      << chunk.size() << " rows one by one: " << errorLine(e)
+                      << std::endl;
+            chunkFailed = true;
+        }
+    }
+    // A failed chunk's transaction is rolled back here
+    stream.reset();
+    txn.reset();
+    if (chunkFailed) {
+        loadOneByOne();
+    }
+    chunk.clear();
+    chunkFailed = false;
+}
+
+void BulkLoader::loadOneByOne() {
+    for (std::size_t i = 0; i < chunk.size(); i++) {
+        const auto& [line, res] = chunk[i];
+        try {
+            pqxx::work one(conn);
+            auto single = openStream(one);
+            writeRow(single, chunkIds[i], res);
+            single.complete();
+            one.commit();
+            noteInserted(chunkIds[i]);
+            insertedRows++;
+        } catch (const pqxx::sql_error& e) {
+            rejectedRows.push_back({line, errorLine(e)});
+        }
+    }
+}
+
+void BulkLoader::noteInserted(int id) {
+    if (!idRanges.empty() && idRanges.back().last + 1 == id) {
+        idRanges.back().last = id;
+    } else {
+        idRanges.push_back({id, id});
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef BULKLOADER_HPP
+#define BULKLOADER_HPP
+
+#include <cstddef>
+#include <optional>
+#include <pqxx/pqxx>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../HTTP/JsonHandler.hpp"
+
+/*
+ * BulkLoader.hpp
+ *
+ * Loads reservations with COPY ... FROM STDIN (pqxx::stream_to) while the
+ * caller is still parsing them. Rows go out as they are added, kChunkRows
+ * to a transaction: memory holds one chunk, not the whole load.
+ *
+ * A row the database refuses (e.g. an overlapping stay) fails the COPY of
+ * its chunk. The rows of that chunk are then loaded again one at a time,
+ * so the others still go in and the refused one is reported by the line
+ * it came from.
+ *
+ * The IDs are drawn from the id sequence with nextval(), which takes no
+ * lock on the table: a running load does not hold up anyone else's
+ * inserts. Concurrent inserts can draw IDs in between, so the IDs of a
+ * load are reported as ranges.
+ */
+class BulkLoader {
+   public:
+    // Rows per COPY, and per transaction
+    static constexpr std::size_t kChunkRows = 1000;
+
+    // A row the database refused
+    struct Rejected {
+        std::size_t line;
+        std::string error;
+    };
+
+    // Consecutive IDs, first and last included, in the order rows were
+    // added
+    struct IdRange {
+        int first;
+        int last;
+    };
+
+    /**
+     * param: conn - connection used until finish(); not to be used
+     *        directly in the meantime
+     * param: maxRows - most rows add() will be given; IDs are drawn for
+     *        that many at most, so rows skipped by the caller only leave
+     *        gaps in the sequence, as a failed INSERT does
+     */
+    BulkLoader(pqxx::connection& conn, std::size_t maxRows);
+
+    BulkLoader(const BulkLoader&) = delete;
+    BulkLoader& operator=(const BulkLoader&) = delete;
+
+    /**
+     * Send a row, and commit its chunk once full
+     *
+     * param: line - reported with the row if the database refuses it
+     * throws: std::logic_error past maxRows; the database error if the
+     *         connection fails (chunks already committed stay loaded)
+     */
+    void add(std::size_t line, const Reservation& res);
+
+    // Commit the last chunk. Throws as add() does.
+    void finish();
+
+    std::size_t inserted() const { return insertedRows; }
+    const std::vector<IdRange>& ids() const { return idRanges; }
+    const std::vector<Rejected>& rejected() const { return rejectedRows; }
+
+   private:
+    pqxx::connection& conn;
+    // Rows add() may still be given that have no ID yet
+    std::size_t unreserved;
+
+    // Chunk being sent: its transaction and COPY (destroyed in reverse
+    // order: the COPY first), the IDs drawn for it and the rows added so
+    // far with their line, kept to load them again one by one
+    std::optional<pqxx::work> txn;
+    std::optional<pqxx::stream_to> stream;
+    std::vector<int> chunkIds;
+    std::vector<std::pair<std::size_t, Reservation>> chunk;
+    bool chunkFailed = false;
+
+    std::size_t insertedRows = 0;
+    std::vector<IdRange> idRanges;
+    std::vector<Rejected> rejectedRows;
+
+    void startChunk();
+    void endChunk();
+    void loadOneByOne();
+    void noteInserted(int id);
+};
+
+#endif
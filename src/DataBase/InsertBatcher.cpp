@@ -0,0 +1,133 @@
+#include "InsertBatcher.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "PostgresDB.hpp"
+
+InsertBatcher::InsertBatcher(PostgresDB& database,
+                             InsertBatcherOptions options_param)
+    : db(database), options(options_param) {
+    if (options.maxBatchSize == 0 ||
+        options.maxBatchSize > PostgresDB::kMaxInsertBatch) {
+        throw std::invalid_argument(
+            "Invalid insert batch size: " +
+            std::to_string(options.maxBatchSize) + ". Must be between 1 and " +
+            std::to_string(PostgresDB::kMaxInsertBatch));
+    }
+    if (options.maxDelay.count() < 0) {
+        throw std::invalid_argument("Invalid insert batch delay: " +
+                                    std::to_string(options.maxDelay.count()) +
+                                    " us. Must not be negative");
+    }
+    pending.reserve(options.maxBatchSize);
+    flusher = std::thread([this] { flushLoop(); });
+}
+
+InsertBatcher::~InsertBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+}
+
+std::future<int> InsertBatcher::submit(const Reservation& res) {
+    std::promise<int> id;
+    std::future<int> result = id.get_future();
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (pending.empty()) {
+            firstSubmitted = std::chrono::steady_clock::now();
+            wake = true;
+        }
+        pending.push_back({res, std::move(id)});
+        wake = wake || pending.size() >= options.maxBatchSize;
+    }
+    // The flusher only needs waking for the first row (to start the delay)
+    // and when the batch is full
+    if (wake) {
+        cv.notify_one();
+    }
+    return result;
+}
+
+InsertBatcher::Stats InsertBatcher::stats() const {
+    Stats result;
+    result.batches = batches.load(std::memory_order_relaxed);
+    result.rows = rows.load(std::memory_order_relaxed);
+    result.fallbacks = fallbacks.load(std::memory_order_relaxed);
+    return result;
+}
+
+void InsertBatcher::flushLoop() {
+    std::vector<Pending> batch;
+    batch.reserve(options.maxBatchSize);
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        cv.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;  // stopping, nothing left to write
+        }
+        // Give other rows until maxDelay after the first one to join
+        cv.wait_until(lock, firstSubmitted + options.maxDelay, [this] {
+            return stopping || pending.size() >= options.maxBatchSize;
+        });
+
+        std::size_t count = std::min(pending.size(), options.maxBatchSize);
+        for (std::size_t i = 0; i < count; i++) {
+            batch.push_back(std::move(pending[i]));
+        }
+        pending.erase(pending.begin(), pending.begin() + count);
+        // Rows left over start their delay now
+        firstSubmitted = std::chrono::steady_clock::now();
+
+        lock.unlock();
+        write(batch);
+        batch.clear();
+        lock.lock();
+    }
+}
+
+void InsertBatcher::write(std::vector<Pending>& batch) {
+    batches.fetch_add(1, std::memory_order_relaxed);
+    rows.fetch_add(batch.size(), std::memory_order_relaxed);
+    try {
+        auto conn = db.getConnectionPool()->acquire();
+
+        std::vector<const Reservation*> reservations;
+        reservations.reserve(batch.size());
+        for (const Pending& row : batch) {
+            reservations.push_back(&row.reservation);
+        }
+        std::vector<int> ids;
+        try {
+            ids = db.insertReservations(*conn, reservations);
+        } catch (const std::exception& e) {
+            // One bad row aborts the whole transaction: find out which by
+            // inserting them one at a time
+            fallbacks.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "[InsertBatcher] Batch of " << batch.size()
+                      << " failed, retrying row by row: " << e.what()
+                      << std::endl;
+            ids.clear();
+            for (const Pending& row : batch) {
+                ids.push_back(db.insertReservation(*conn, row.reservation));
+            }
+        }
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            batch[i].id.set_value(ids[i]);
+        }
+    } catch (...) {
+        // No connection: every caller sees the error from future.get()
+        for (Pending& row : batch) {
+            row.id.set_exception(std::current_exception());
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef INSERTBATCHER_HPP
+#define INSERTBATCHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../HTTP/JsonHandler.hpp"
+
+class PostgresDB;
+
+struct InsertBatcherOptions {
+    // Rows written by one INSERT at most
+    std::size_t maxBatchSize = 32;
+    // Longest time the first row of a batch waits for others to join it
+    std::chrono::microseconds maxDelay{1000};
+};
+
+/*
+ * InsertBatcher.hpp
+ *
+ * Group commit for reservation inserts. Callers submit() a reservation and
+ * get a future for its ID; a flusher thread gathers the rows submitted
+ * within maxDelay (or until maxBatchSize of them) and writes them with a
+ * single multi-row INSERT in one transaction, so they share one commit and
+ * one fsync instead of paying one each.
+ *
+ * A batch the database rejects as a whole (e.g. one row overlaps an
+ * existing reservation) is retried row by row, so each caller gets the
+ * same answer it would have got from insertReservation(): its ID or -1.
+ */
+class InsertBatcher {
+   public:
+    struct Stats {
+        std::uint64_t batches = 0;
+        std::uint64_t rows = 0;
+        // Batches that failed and were retried row by row
+        std::uint64_t fallbacks = 0;
+    };
+
+    // throws: std::invalid_argument on out of range options
+    InsertBatcher(PostgresDB& database, InsertBatcherOptions options);
+
+    // Writes the rows still pending, then stops the flusher
+    ~InsertBatcher();
+
+    InsertBatcher(const InsertBatcher&) = delete;
+    InsertBatcher& operator=(const InsertBatcher&) = delete;
+
+    /**
+     * Queue a reservation for the next batch
+     *
+     * return: future for the assigned ID, -1 if the row was rejected.
+     *         Holds PoolUnavailable if no connection could be leased.
+     */
+    std::future<int> submit(const Reservation& res);
+
+    Stats stats() const;
+
+   private:
+    struct Pending {
+        Reservation reservation;
+        std::promise<int> id;
+    };
+
+    PostgresDB& db;
+    InsertBatcherOptions options;
+    std::vector<Pending> pending;
+    // When the oldest pending row was submitted
+    std::chrono::steady_clock::time_point firstSubmitted;
+    bool stopping = false;
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    std::atomic<std::uint64_t> batches{0};
+    std::atomic<std::uint64_t> rows{0};
+    std::atomic<std::uint64_t> fallbacks{0};
+
+    // Started last, once everything it reads is initialized
+    std::thread flusher;
+
+    void flushLoop();
+    void write(std::vector<Pending>& batch);
+};
+
+#endif
@@ -0,0 +1,368 @@
+#include "PartitionMaintainer.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Advisory lock (one bigint key space) held by the server running a
+// maintenance pass or a bootstrap
+constexpr const char* kLockKey = "hashtext('reservations_partitions')";
+
+constexpr const char* kPrefix = "reservations_";
+
+// Same columns as the plain table. The primary key of a partitioned table
+// must contain the partition key, hence (id, check_in_date).
+std::string createTableSql() {
+    return R"(
+    CREATE TABLE reservations (
+        id serial,
+        guest_name text NOT NULL,
+        guest_email text NOT NULL,
+        guest_phone text NOT NULL,
+        room_number integer NOT NULL,
+        room_type text NOT NULL,
+        number_of_guests integer NOT NULL,
+        check_in_date date NOT NULL,
+        check_out_date date NOT NULL,
+        number_of_nights integer NOT NULL,
+        price_per_night double precision NOT NULL,
+        total_price double precision NOT NULL,
+        payment_method text NOT NULL,
+        paid boolean NOT NULL,
+        reservation_status text NOT NULL,
+        special_requests text NOT NULL DEFAULT '',
+        created_at bigint NOT NULL,
+        updated_at bigint NOT NULL,
+        PRIMARY KEY (id, check_in_date),
+        CONSTRAINT reservations_stay_length CHECK (
+            check_out_date >= check_in_date AND
+            check_out_date <= check_in_date + )" +
+           std::to_string(PartitionMaintainer::kMaxStayDays) + R"()
+    ) PARTITION BY RANGE (check_in_date)
+)";
+}
+
+// A check-out on the day of the next check-in overlaps, as in the
+// constraint of the plain table. The lower bound on check_in_date prunes
+// the partitions no overlapping stay can be in. Each statement of a
+// volatile function takes a new snapshot, so once the lock is held the
+// rows of the writer before are visible.
+std::string overlapTriggerSql() {
+    return R"(
+    CREATE FUNCTION reservations_no_overlap() RETURNS trigger
+    LANGUAGE plpgsql AS $$
+    BEGIN
+        PERFORM pg_advisory_xact_lock('reservations'::regclass::oid::int,
+                                      NEW.room_number);
+        IF EXISTS (
+            SELECT 1 FROM reservations
+            WHERE room_number = NEW.room_number
+              AND id <> NEW.id
+              AND check_in_date <= NEW.check_out_date
+              AND check_out_date >= NEW.check_in_date
+              AND check_in_date >= NEW.check_in_date - )" +
+           std::to_string(PartitionMaintainer::kMaxStayDays) + R"(
+        ) THEN
+            RAISE EXCEPTION 'Room % is already booked for an overlapping stay',
+                NEW.room_number USING ERRCODE = 'exclusion_violation';
+        END IF;
+        RETURN NEW;
+    END
+    $$
+)";
+}
+
+void checkOptions(const PartitionOptions& options) {
+    if (options.monthsAhead < 1 || options.monthsBehind < 0 ||
+        options.retentionMonths < 0 ||
+        (options.retentionMonths > 0 &&
+         options.retentionMonths <= options.monthsBehind) ||
+        options.archiveSchema.empty() || options.interval.count() <= 0) {
+        throw std::invalid_argument(
+            "Invalid partition settings: " +
+            std::to_string(options.monthsAhead) + " months ahead, " +
+            std::to_string(options.monthsBehind) + " behind, retention " +
+            std::to_string(options.retentionMonths) + ", interval " +
+            std::to_string(options.interval.count()) +
+            " ms. Months ahead and the interval must be positive, the "
+            "retention 0 or more than the months behind, and the archive "
+            "schema named");
+    }
+}
+
+// First day of month, as a SQL literal
+std::string firstDay(std::chrono::year_month month) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "'%04d-%02u-01'",
+                  static_cast<int>(month.year()),
+                  static_cast<unsigned>(month.month()));
+    return text;
+}
+
+// YYYY-MM-DD; std::nullopt for anything else, or a day that does not exist
+std::optional<std::chrono::year_month_day> parseDate(std::string_view text) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') {
+        return std::nullopt;
+    }
+    const char* data = text.data();
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    if (std::from_chars(data, data + 4, year).ptr != data + 4 ||
+        std::from_chars(data + 5, data + 7, month).ptr != data + 7 ||
+        std::from_chars(data + 8, data + 10, day).ptr != data + 10) {
+        return std::nullopt;
+    }
+    std::chrono::year_month_day date{std::chrono::year(year),
+                                     std::chrono::month(month),
+                                     std::chrono::day(day)};
+    if (!date.ok()) {
+        return std::nullopt;
+    }
+    return date;
+}
+
+std::string isoDate(std::chrono::year_month_day date) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%04d-%02u-%02u",
+                  static_cast<int>(date.year()),
+                  static_cast<unsigned>(date.month()),
+                  static_cast<unsigned>(date.day()));
+    return text;
+}
+
+}  // namespace
+
+PartitionMaintainer::PartitionMaintainer(ConnectionPool& pool_param,
+                                         PartitionOptions options_param)
+    : pool(pool_param), options(std::move(options_param)) {
+    checkOptions(options);
+    worker = std::thread([this] { maintainLoop(); });
+}
+
+PartitionMaintainer::~PartitionMaintainer() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PartitionMaintainer::maintainLoop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!cv.wait_for(lock, options.interval, [this] { return stopping; })) {
+        lock.unlock();
+        try {
+            auto conn = pool.acquire();
+            maintain(*conn, options, currentMonth());
+        } catch (const std::exception& e) {
+            // Retried on the next pass; the months ahead leave time for it
+            std::cerr << "[PartitionMaintainer] Maintenance failed: "
+                      << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+bool PartitionMaintainer::bootstrap(pqxx::connection& conn) {
+    pqxx::work txn(conn);
+    // Servers starting together create the table once
+    txn.exec(std::string("SELECT pg_advisory_xact_lock(") + kLockKey + ")");
+    auto kind = txn.exec(
+        "SELECT relkind FROM pg_class WHERE oid = to_regclass('reservations')");
+    if (!kind.empty()) {
+        bool partitioned = kind[0][0].as<std::string>() == "p";
+        if (!partitioned) {
+            std::cerr << "[PartitionMaintainer] reservations is a plain "
+                         "table, not partitioning it"
+                      << std::endl;
+        }
+        return partitioned;
+    }
+    std::cout << "[PartitionMaintainer] Creating partitioned table "
+                 "reservations"
+              << std::endl;
+    txn.exec(createTableSql());
+    txn.exec(overlapTriggerSql());
+    txn.exec(
+        "CREATE TRIGGER reservations_no_overlap "
+        "BEFORE INSERT OR UPDATE ON reservations "
+        "FOR EACH ROW EXECUTE FUNCTION reservations_no_overlap()");
+    txn.commit();
+    return true;
+}
+
+bool PartitionMaintainer::isPartitioned(pqxx::connection& conn) {
+    pqxx::nontransaction txn(conn);
+    auto result = txn.exec(R"(
+        SELECT 1 FROM pg_class c JOIN pg_constraint k ON k.conrelid = c.oid
+        WHERE c.oid = to_regclass('reservations')
+          AND c.relkind = 'p'
+          AND k.conname = 'reservations_stay_length'
+    )");
+    return !result.empty();
+}
+
+PartitionMaintainer::Pass PartitionMaintainer::maintain(
+    pqxx::connection& conn, const PartitionOptions& options,
+    std::chrono::year_month current) {
+    checkOptions(options);
+    Pass pass;
+    // DETACH ... CONCURRENTLY cannot run inside a transaction block
+    pqxx::nontransaction txn(conn);
+    if (!txn.exec(std::string("SELECT pg_try_advisory_lock(") + kLockKey +
+                  ")")[0][0]
+             .as<bool>()) {
+        return pass;
+    }
+    try {
+        std::set<std::string> existing;
+        std::set<std::string> detaching;
+        auto partitions = txn.exec(R"(
+            SELECT c.relname, i.inhdetachpending
+            FROM pg_inherits i JOIN pg_class c ON c.oid = i.inhrelid
+            WHERE i.inhparent = 'reservations'::regclass
+        )");
+        for (const auto& row : partitions) {
+            existing.insert(row[0].as<std::string>());
+            if (row[1].as<bool>()) {
+                detaching.insert(row[0].as<std::string>());
+            }
+        }
+
+        using std::chrono::months;
+        // One spare month past the window (see checkStay)
+        for (auto month = current - months(options.monthsBehind);
+             month <= current + months(options.monthsAhead + 1);
+             month += months(1)) {
+            std::string name = partitionName(month);
+            if (existing.count(name) > 0) {
+                continue;
+            }
+            std::cout << "[PartitionMaintainer] Creating partition " << name
+                      << std::endl;
+            // Created apart and attached: ATTACH PARTITION does not block
+            // queries on reservations, CREATE TABLE ... PARTITION OF does
+            txn.exec("CREATE TABLE IF NOT EXISTS " + name +
+                     " (LIKE reservations INCLUDING DEFAULTS "
+                     "INCLUDING CONSTRAINTS)");
+            txn.exec("ALTER TABLE reservations ATTACH PARTITION " + name +
+                     " FOR VALUES FROM (" + firstDay(month) + ") TO (" +
+                     firstDay(month + months(1)) + ")");
+            pass.created.push_back(name);
+        }
+
+        if (options.retentionMonths > 0) {
+            auto oldest = current - months(options.retentionMonths);
+            std::string archive = txn.quote_name(options.archiveSchema);
+            for (const std::string& name : existing) {
+                auto month = partitionMonth(name);
+                if (!month || *month >= oldest) {
+                    continue;
+                }
+                std::cout << "[PartitionMaintainer] Archiving partition "
+                          << name << " to " << options.archiveSchema
+                          << std::endl;
+                txn.exec("CREATE SCHEMA IF NOT EXISTS " + archive);
+                // A detach interrupted on a previous pass is completed
+                txn.exec("ALTER TABLE reservations DETACH PARTITION " + name +
+                         (detaching.count(name) > 0 ? " FINALIZE"
+                                                    : " CONCURRENTLY"));
+                txn.exec("ALTER TABLE " + name + " SET SCHEMA " + archive);
+                pass.archived.push_back(name);
+            }
+        }
+    } catch (...) {
+        try {
+            txn.exec(std::string("SELECT pg_advisory_unlock(") + kLockKey +
+                     ")");
+        } catch (const std::exception&) {
+            // A broken connection released the lock with its session
+        }
+        throw;
+    }
+    txn.exec(std::string("SELECT pg_advisory_unlock(") + kLockKey + ")");
+    return pass;
+}
+
+void PartitionMaintainer::checkStay(const PartitionOptions& options,
+                                    std::chrono::year_month current,
+                                    std::string_view checkIn,
+                                    std::string_view checkOut) {
+    auto in = parseDate(checkIn);
+    auto out = parseDate(checkOut);
+    if (!in || !out) {
+        return;
+    }
+    using std::chrono::months;
+    std::chrono::year_month first = current - months(options.monthsBehind);
+    std::chrono::year_month last = current + months(options.monthsAhead);
+    std::chrono::year_month month = in->year() / in->month();
+    if (month < first || month > last) {
+        throw StayOutsidePartitions(
+            "check_in_date " + std::string(checkIn) +
+            " is outside the dates reservations are taken for: " +
+            isoDate(first / std::chrono::day(1)) + " to " +
+            isoDate(last / std::chrono::last));
+    }
+    auto nights = (std::chrono::sys_days(*out) - std::chrono::sys_days(*in))
+                      .count();
+    if (nights > kMaxStayDays) {
+        throw StayOutsidePartitions("Stays last at most " +
+                                    std::to_string(kMaxStayDays) +
+                                    " nights, this one " +
+                                    std::to_string(nights));
+    }
+}
+
+void PartitionMaintainer::checkStay(std::string_view checkIn,
+                                    std::string_view checkOut) const {
+    checkStay(options, currentMonth(), checkIn, checkOut);
+}
+
+std::chrono::year_month PartitionMaintainer::currentMonth() {
+    std::chrono::year_month_day today(
+        std::chrono::floor<std::chrono::days>(
+            std::chrono::system_clock::now()));
+    return today.year() / today.month();
+}
+
+std::string PartitionMaintainer::partitionName(std::chrono::year_month month) {
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "%04d_%02u",
+                  static_cast<int>(month.year()),
+                  static_cast<unsigned>(month.month()));
+    return kPrefix + std::string(suffix);
+}
+
+std::optional<std::chrono::year_month> PartitionMaintainer::partitionMonth(
+    std::string_view name) {
+    std::string_view prefix = kPrefix;
+    bool shaped = name.size() == prefix.size() + 7 &&
+                  name.substr(0, prefix.size()) == prefix &&
+                  name[prefix.size() + 4] == '_';
+    if (!shaped) {
+        return std::nullopt;
+    }
+    const char* text = name.data() + prefix.size();
+    int year = 0;
+    unsigned month = 0;
+    if (std::from_chars(text, text + 4, year).ptr != text + 4 ||
+        std::from_chars(text + 5, text + 7, month).ptr != text + 7) {
+        return std::nullopt;
+    }
+    std::chrono::year_month result{std::chrono::year(year),
+                                   std::chrono::month(month)};
+    if (!result.ok()) {
+        return std::nullopt;
+    }
+    return result;
+}
@@ -0,0 +1,159 @@
+#ifndef PARTITIONMAINTAINER_HPP
+#define PARTITIONMAINTAINER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <pqxx/pqxx>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../Utils/ConnectionPool.hpp"
+
+struct PartitionOptions {
+    // Months after the current one that get their partition in advance
+    int monthsAhead = 12;
+    // Months before the current one that still get a partition, for stays
+    // entered after the fact
+    int monthsBehind = 3;
+    // Partitions of months older than this many months before the current
+    // one are detached and moved to archiveSchema (0 = kept forever)
+    int retentionMonths = 0;
+    std::string archiveSchema = "reservations_archive";
+    // Time between two maintenance passes
+    std::chrono::milliseconds interval{3600000};
+};
+
+// A stay the partitioned table cannot hold: checking in a month outside
+// the partition window, or longer than PartitionMaintainer::kMaxStayDays
+class StayOutsidePartitions : public std::invalid_argument {
+   public:
+    using std::invalid_argument::invalid_argument;
+};
+
+/*
+ * PartitionMaintainer.hpp
+ *
+ * Optional monthly partitioning of the reservations table by check-in
+ * date. Each month is its own table, reservations_YYYY_MM, with its own
+ * indexes: vacuum and index maintenance work on one month at a time, and
+ * old months leave the hot table altogether.
+ *
+ * bootstrap() creates the partitioned table when there is none yet (an
+ * existing plain table is left as it is). A maintenance pass then creates
+ * the partitions of the months ahead and archives the ones past the
+ * retention: detached without blocking queries, and moved to another
+ * schema, where they can be dumped or dropped.
+ *
+ * There is no DEFAULT partition: it would stop DETACH ... CONCURRENTLY,
+ * and an ATTACH of a month it holds rows of. A stay checking in outside
+ * the window is refused by the database, so checkStay() lets callers
+ * refuse it first, with a message that names the window.
+ *
+ * Partitions do not share indexes, so the table constraint against
+ * overlapping stays becomes a trigger that checks every partition, under a
+ * per-room advisory lock so concurrent writers of a room take turns.
+ */
+class PartitionMaintainer {
+   public:
+    // Longest stay the partitioned table accepts, in days. A stay
+    // overlapping a given day starts at most this long before it, which
+    // gives date searches a lower bound on the partition key (see
+    // PostgresDB::isPartitioned).
+    static constexpr int kMaxStayDays = 366;
+
+    // Tables touched by one maintenance pass
+    struct Pass {
+        std::vector<std::string> created;
+        std::vector<std::string> archived;
+    };
+
+    /**
+     * Run a maintenance pass every options.interval on its own thread,
+     * with a connection leased from pool for each pass. The first pass is
+     * left to the caller (see PostgresDB), which needs the partitions
+     * before it serves anything.
+     *
+     * param: pool - must outlive this object
+     * throws: std::invalid_argument on out of range options
+     */
+    PartitionMaintainer(ConnectionPool& pool, PartitionOptions options);
+
+    // Stops the thread, waiting for a pass in progress
+    ~PartitionMaintainer();
+
+    PartitionMaintainer(const PartitionMaintainer&) = delete;
+    PartitionMaintainer& operator=(const PartitionMaintainer&) = delete;
+
+    /**
+     * Create the partitioned reservations table, its stay length check and
+     * its overlap trigger, if no reservations table exists in the current
+     * schema. Partitions are left to maintain().
+     *
+     * return: whether reservations is now a partitioned table
+     */
+    static bool bootstrap(pqxx::connection& conn);
+
+    // True when reservations is a table bootstrap() created: partitioned,
+    // with stays of at most kMaxStayDays
+    static bool isPartitioned(pqxx::connection& conn);
+
+    /**
+     * One maintenance pass: create the missing partitions from
+     * monthsBehind before current to monthsAhead after it, and one spare
+     * month after those, then archive those older than the retention.
+     * Does nothing while another server runs a pass on the same database.
+     *
+     * The spare month keeps the window of checkStay() covered when the
+     * month turns before the next pass.
+     *
+     * throws: the database error; tables already handled stay so
+     */
+    static Pass maintain(pqxx::connection& conn,
+                         const PartitionOptions& options,
+                         std::chrono::year_month current);
+
+    /**
+     * Check a stay against the partition window as of current: check-in
+     * from the first day of the month monthsBehind before current to the
+     * last day of the month monthsAhead after it, and at most kMaxStayDays
+     * long. Dates that are not YYYY-MM-DD are left to the database.
+     *
+     * throws: StayOutsidePartitions, naming the window
+     */
+    static void checkStay(const PartitionOptions& options,
+                          std::chrono::year_month current,
+                          std::string_view checkIn,
+                          std::string_view checkOut);
+
+    // Same, with the options of this maintainer and currentMonth()
+    void checkStay(std::string_view checkIn, std::string_view checkOut) const;
+
+    // Month of today's date (UTC)
+    static std::chrono::year_month currentMonth();
+
+    // reservations_YYYY_MM
+    static std::string partitionName(std::chrono::year_month month);
+
+    // Month of a partitionName(); std::nullopt for any other name
+    static std::optional<std::chrono::year_month> partitionMonth(
+        std::string_view name);
+
+   private:
+    ConnectionPool& pool;
+    PartitionOptions options;
+    bool stopping = false;
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    // Started last, once everything it reads is initialized
+    std::thread worker;
+
+    void maintainLoop();
+};
+
+#endif
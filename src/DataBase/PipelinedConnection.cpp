@@ -0,0 +1,91 @@
+#include "PipelinedConnection.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+PipelinedConnection::PipelinedConnection(pqxx::connection& conn_param)
+    : conn(conn_param), raw(nullptr) {
+    if (!conn.is_open()) {
+        throw std::runtime_error("Connection lost");
+    }
+    raw = std::move(conn).release_raw_connection();
+    if (PQenterPipelineMode(raw) != 1) {
+        std::string error = PQerrorMessage(raw);
+        conn = pqxx::connection::seize_raw_connection(raw);
+        throw std::runtime_error("Cannot enter pipeline mode: " + error);
+    }
+}
+
+PipelinedConnection::~PipelinedConnection() {
+    try {
+        while (inFlight > 0) {
+            nextResult();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[PipelinedConnection] " << e.what() << std::endl;
+    }
+    bool clean = PQexitPipelineMode(raw) == 1 &&
+                 PQtransactionStatus(raw) == PQTRANS_IDLE;
+    conn = pqxx::connection::seize_raw_connection(raw);
+    if (!clean) {
+        std::cerr << "[PipelinedConnection] Connection left mid-pipeline, "
+                     "closing it"
+                  << std::endl;
+        conn.close();
+    }
+}
+
+void PipelinedConnection::sendPrepared(const char* statement,
+                                       const std::vector<std::string>& params) {
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const std::string& param : params) {
+        values.push_back(param.c_str());
+    }
+    if (PQsendQueryPrepared(raw, statement, static_cast<int>(values.size()),
+                            values.data(), nullptr, nullptr, 0) != 1) {
+        fail("Cannot send statement");
+    }
+    // Flushes the output buffer too: the server starts on it right away
+    if (PQpipelineSync(raw) != 1) {
+        fail("Cannot send sync point");
+    }
+    inFlight++;
+}
+
+void PipelinedConnection::sendQuery(const char* sql) {
+    // Pipeline mode only takes the extended protocol, even without
+    // parameters
+    if (PQsendQueryParams(raw, sql, 0, nullptr, nullptr, nullptr, nullptr,
+                          0) != 1) {
+        fail("Cannot send statement");
+    }
+    if (PQpipelineSync(raw) != 1) {
+        fail("Cannot send sync point");
+    }
+    inFlight++;
+}
+
+PipelinedConnection::Result PipelinedConnection::nextResult() {
+    if (inFlight == 0) {
+        throw std::logic_error("No pipelined statement pending");
+    }
+    // Each statement yields its result, a nullptr ending it, and then the
+    // PGRES_PIPELINE_SYNC of the sync point sent after it
+    Result result(PQgetResult(raw));
+    if (!result) {
+        fail("Missing pipelined result");
+    }
+    Result end(PQgetResult(raw));
+    Result sync(PQgetResult(raw));
+    if (end || !sync || PQresultStatus(sync.get()) != PGRES_PIPELINE_SYNC) {
+        fail("Unexpected pipelined result");
+    }
+    inFlight--;
+    return result;
+}
+
+void PipelinedConnection::fail(const std::string& what) const {
+    throw std::runtime_error(what + ": " + PQerrorMessage(raw));
+}
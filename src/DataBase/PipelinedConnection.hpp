@@ -0,0 +1,95 @@
+#ifndef PIPELINEDCONNECTION_HPP
+#define PIPELINEDCONNECTION_HPP
+
+#include <libpq-fe.h>
+
+#include <cstddef>
+#include <memory>
+#include <pqxx/pqxx>
+#include <string>
+#include <vector>
+
+/*
+ * PipelinedConnection.hpp
+ *
+ * libpq pipeline mode on a pool connection. Without it every statement
+ * waits a full round trip for its result before the next one is sent; in
+ * pipeline mode statements are sent back to back and their results read
+ * afterwards, in order, so N statements cost about one round trip.
+ *
+ * libpqxx has no pipeline mode of its own, so while this object lives it
+ * takes the raw libpq handle out of the pqxx::connection, and puts it back
+ * when destroyed. It stays the same server session: statements prepared
+ * on the connection (PostgresDB::prepareStatements) can be executed.
+ *
+ * Every statement is followed by a sync point, so each one runs in its own
+ * implicit transaction and a failing one does not abort those after it,
+ * unless the statements are put in a transaction block with sendQuery()
+ * (a sync point does not end an explicit transaction).
+ */
+class PipelinedConnection {
+   public:
+    struct ResultDeleter {
+        void operator()(PGresult* result) const { PQclear(result); }
+    };
+    using Result = std::unique_ptr<PGresult, ResultDeleter>;
+
+    /**
+     * Enter pipeline mode on conn
+     *
+     * param: conn - open connection, e.g. from a ConnectionPool lease; it
+     *        must not be used directly until this object is destroyed
+     * throws: std::runtime_error if pipeline mode cannot be entered
+     */
+    explicit PipelinedConnection(pqxx::connection& conn);
+
+    /**
+     * Read the results still pending, leave pipeline mode and give the
+     * handle back to conn. A connection left in an unknown state, or inside
+     * a transaction block, is closed instead, so the pool reconnects it on
+     * its next lease.
+     */
+    ~PipelinedConnection();
+
+    PipelinedConnection(const PipelinedConnection&) = delete;
+    PipelinedConnection& operator=(const PipelinedConnection&) = delete;
+
+    /**
+     * Queue a prepared statement, without waiting for its result
+     *
+     * param: statement - name given to pqxx::connection::prepare
+     * param: params - parameters in text format
+     * throws: std::runtime_error if it cannot be sent
+     */
+    void sendPrepared(const char* statement,
+                      const std::vector<std::string>& params);
+
+    /**
+     * Queue a statement without parameters, such as BEGIN or COMMIT
+     *
+     * throws: std::runtime_error if it cannot be sent
+     */
+    void sendQuery(const char* sql);
+
+    /**
+     * Result of the oldest statement not read yet, blocking until it
+     * arrives. Check PQresultStatus(): PGRES_FATAL_ERROR for a statement
+     * the server rejected.
+     *
+     * throws: std::logic_error if nothing is pending,
+     *         std::runtime_error if the connection failed
+     */
+    Result nextResult();
+
+    // Statements sent whose result has not been read
+    std::size_t pending() const { return inFlight; }
+
+   private:
+    pqxx::connection& conn;
+    PGconn* raw;
+    std::size_t inFlight = 0;
+
+    [[noreturn]] void fail(const std::string& what) const;
+};
+
+#endif
@@ -1,21 +1,60 @@
 #include "PostgresDB.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 #include "../config/ConfigManager.hpp"
+#include "PipelinedConnection.hpp"
+#include "ReservationParams.hpp"
+
+namespace {
+
+// Optional integer setting, at least minimum
+int intSetting(const ConfigManager& config, const std::string& key,
+               int defaultValue, int minimum) {
+    int value = config.getInt(key, defaultValue);
+    if (value < minimum) {
+        throw std::invalid_argument("Invalid setting: " + key + "=" +
+                                    std::to_string(value) + ". " + key +
+                                    " must be at least " +
+                                    std::to_string(minimum));
+    }
+    return value;
+}
+
+PartitionOptions partitionOptions(const ConfigManager& config) {
+    PartitionOptions options;
+    options.monthsAhead = intSetting(config, "DB_PARTITION_MONTHS_AHEAD", 0, 0);
+    options.monthsBehind = intSetting(config, "DB_PARTITION_MONTHS_BEHIND",
+                                      options.monthsBehind, 0);
+    options.retentionMonths = intSetting(
+        config, "DB_PARTITION_RETENTION_MONTHS", options.retentionMonths, 0);
+    options.archiveSchema =
+        config.get("DB_PARTITION_ARCHIVE_SCHEMA", options.archiveSchema);
+    options.interval = std::chrono::milliseconds(
+        intSetting(config, "DB_PARTITION_CHECK_MS",
+                   static_cast<int>(options.interval.count()), 1));
+    return options;
+}
+
+}  // namespace
 
 PostgresDB::PostgresDB(const ConfigManager& config)
     : conn(buildConnectionString(config)),
-      pool(buildConnectionString(config), 4) {
+      partitioned(setUpPartitioning(conn, config)),
+      pool(buildConnectionString(config), buildPoolOptions(config)),
+      recentWriters(std::chrono::milliseconds(
+          intSetting(config, "DB_READ_YOUR_WRITES_MS", 2000, 0))) {
     /*
      * RAII in action:
      * - Constructor parameter: ConfigManager with validated credentials
      * - Member initializer 1: conn(buildConnectionString(config))
      *   This OPENS the primary connection immediately
-     * - Member initializer 2: pool(buildConnectionString(config), 4)
-     *   This OPENS 4 additional connections in the ConnectionPool
-     *   Workers will acquire/release these connections via getConnectionPool()
+     * - Member initializer 2: pool(buildConnectionString(config), options)
+     *   This OPENS DB_POOL_MIN additional connections in the ConnectionPool,
+     *   which grows up to DB_POOL_MAX under load
+     *   Workers lease these connections via getConnectionPool()
      * - If connection fails, exception thrown before object is fully
      * constructed
      * - Caller sees the exception, knows something is wrong
@@ -24,10 +63,53 @@ PostgresDB::PostgresDB(const ConfigManager& config)
     if (!conn.is_open()) {
         throw std::runtime_error("[PostgresDB] Failed to connect to database");
     }
+    prepareStatements(conn);
+    ensureIndexes(conn);
+
+    int batchSize = config.getInt("DB_INSERT_BATCH_SIZE", 1);
+    if (batchSize > 1) {
+        InsertBatcherOptions batchOptions;
+        batchOptions.maxBatchSize = static_cast<std::size_t>(batchSize);
+        batchOptions.maxDelay = std::chrono::microseconds(config.getInt(
+            "DB_INSERT_BATCH_DELAY_US",
+            static_cast<int>(batchOptions.maxDelay.count())));
+        insertBatcher = std::make_unique<InsertBatcher>(*this, batchOptions);
+    } else if (batchSize < 1) {
+        throw std::invalid_argument(
+            "Invalid insert batch size: " + std::to_string(batchSize) +
+            ". DB_INSERT_BATCH_SIZE must be at least 1");
+    }
+
+    PartitionOptions partitioning = partitionOptions(config);
+    if (partitioning.monthsAhead > 0 && partitioned) {
+        partitionMaintainer =
+            std::make_unique<PartitionMaintainer>(pool, partitioning);
+    }
+
+    if (!config.get("DB_READ_HOST", "").empty()) {
+        ConnectionPoolOptions readOptions = buildPoolOptions(config);
+        try {
+            readPool = std::make_unique<ConnectionPool>(
+                buildReadConnectionString(config), readOptions);
+        } catch (const pqxx::broken_connection& e) {
+            // Reads fall back to the primary until the replica is back:
+            // the pool then opens connections on demand
+            std::cerr << "[PostgresDB] Read replica unreachable, reading "
+                         "from the primary for now: "
+                      << e.what() << std::endl;
+            readOptions.minSize = 0;
+            readPool = std::make_unique<ConnectionPool>(
+                buildReadConnectionString(config), readOptions);
+        }
+        std::cout << "[PostgresDB] Routing reads to replica "
+                  << config.get("DB_READ_HOST") << std::endl;
+    }
 
     std::cout << "[PostgresDB] Connected successfully" << std::endl;
-    std::cout << "[PostgresDB] Connection pool initialized with 4 connections"
-              << std::endl;
+    ConnectionPool::Stats poolStats = pool.stats();
+    std::cout << "[PostgresDB] Connection pool initialized with "
+              << poolStats.size << " connections (max " << poolStats.maxSize
+              << ")" << std::endl;
 }
 
 PostgresDB::~PostgresDB() {
@@ -44,14 +126,18 @@ PostgresDB::~PostgresDB() {
     // conn destructor runs here, closes connection
 }
 
+InsertBatcher* PostgresDB::getInsertBatcher() const {
+    return insertBatcher.get();
+}
+
 ConnectionPool* PostgresDB::getConnectionPool() const {
     /*
      * Provides access to the connection pool for worker threads
      *
      * Usage in ClientConnection:
      *   auto conn = db->getConnectionPool()->acquire();
-     *   // ... use connection ...
-     *   db->getConnectionPool()->release(std::move(conn));
+     *   // ... use *conn ...
+     *   // the lease gives the connection back when it goes out of scope
      *
      * Why const_cast needed on pool?
      * - pool is mutable member (marked with mutable keyword)
@@ -61,6 +147,45 @@ ConnectionPool* PostgresDB::getConnectionPool() const {
     return const_cast<ConnectionPool*>(&pool);
 }
 
+ConnectionPool* PostgresDB::getReadPool() const { return readPool.get(); }
+
+void PostgresDB::noteWrite(std::string_view client) {
+    if (readPool) {
+        recentWriters.noteWrite(client);
+    }
+}
+
+ConnectionPool::Lease PostgresDB::acquireReadConnection(
+    std::string_view client) {
+    if (readPool && !recentWriters.wroteRecently(client)) {
+        try {
+            auto conn = readPool->acquire();
+            replicaReads++;
+            return conn;
+        } catch (const PoolUnavailable& e) {
+            noteFallback(e);
+        }
+    } else if (readPool) {
+        primaryReads++;
+    }
+    return pool.acquire();
+}
+
+ReadRoutingStats PostgresDB::readRoutingStats() const {
+    ReadRoutingStats stats;
+    stats.replicaReads = replicaReads.load();
+    stats.primaryReads = primaryReads.load();
+    stats.fallbacks = fallbacks.load();
+    return stats;
+}
+
+void PostgresDB::noteFallback(const std::exception& error) {
+    fallbacks++;
+    std::cerr << "[PostgresDB] Read replica failed, reading from the "
+                 "primary: "
+              << error.what() << std::endl;
+}
+
 std::string PostgresDB::buildConnectionString(const ConfigManager& config) {
     /*
      * Purpose: Take validated config and format it for PostgreSQL
@@ -91,143 +216,384 @@ std::string PostgresDB::buildConnectionString(const ConfigManager& config) {
     return oss.str();
 }
 
-bool PostgresDB::isConnected() const { return conn.is_open(); }
+std::string PostgresDB::buildReadConnectionString(
+    const ConfigManager& config) {
+    std::ostringstream oss;
+    oss << "host=" << config.get("DB_READ_HOST")
+        << " port=" << config.getInt("DB_READ_PORT", config.getInt("DB_PORT"))
+        << " dbname=" << config.get("DB_NAME")
+        << " user=" << config.get("DB_USER")
+        << " password=" << config.get("DB_PASSWORD");
+    return oss.str();
+}
 
-int PostgresDB::insertReservation(const Reservation& res) {
-    /*
-     * Big picture: Take a Reservation C++ object, insert it into PostgreSQL
-     *
-     * Steps:
-     * 1. Verify connection still open
-     * 2. Start transaction (all-or-nothing)
-     * 3. Execute INSERT SQL with parameters
-     * 4. Commit transaction
-     * 5. Return the assigned ID (or -1 on failure)
-     */
+namespace {
+
+/*
+ * SQL of the statements prepareStatements() prepares under the names in
+ * PostgresDB.hpp. Executing one sends only its name and the parameter
+ * values: PostgreSQL parses and plans the text once per connection, not
+ * once per request.
+ */
+
+// RETURNING id gives back the ID assigned by the database
+constexpr const char* kInsertReservationSql = R"(
+    INSERT INTO reservations (
+        guest_name, guest_email, guest_phone,
+        room_number, room_type, number_of_guests,
+        check_in_date, check_out_date, number_of_nights,
+        price_per_night, total_price, payment_method, paid,
+        reservation_status, special_requests,
+        created_at, updated_at
+    ) VALUES (
+        $1, $2, $3,
+        $4, $5, $6,
+        $7, $8, $9,
+        $10, $11, $12, $13,
+        $14, $15,
+        $16, $17
+    )
+    RETURNING id
+)";
+
+// Multi-row form used by insertReservations(), with the IDs drawn
+// beforehand: "VALUES" is followed by one ($n, ...) group of kInsertColumns
+// parameters per row, the ID first
+constexpr std::size_t kInsertColumns = 18;
+constexpr const char* kInsertBatchPrefix = R"(
+    INSERT INTO reservations (
+        id, guest_name, guest_email, guest_phone,
+        room_number, room_type, number_of_guests,
+        check_in_date, check_out_date, number_of_nights,
+        price_per_night, total_price, payment_method, paid,
+        reservation_status, special_requests,
+        created_at, updated_at
+    ) VALUES )";
+
+// $1 IDs from the id sequence. nextval() takes no lock and is not rolled
+// back: IDs drawn for rows that fail are skipped, not reused.
+constexpr const char* kDrawIdsSql = R"(
+    SELECT nextval(pg_get_serial_sequence('reservations', 'id'))
+    FROM generate_series(1, $1)
+)";
+
+constexpr const char* kGetReservationSql = R"(
+    SELECT guest_name, guest_email, guest_phone,
+           room_number, room_type, number_of_guests,
+           check_in_date, check_out_date, number_of_nights,
+           price_per_night, total_price, payment_method, paid,
+           reservation_status, special_requests,
+           created_at, updated_at
+    FROM reservations
+    WHERE id = $1
+)";
+
+constexpr const char* kUpdateReservationSql = R"(
+    UPDATE reservations SET
+        guest_name = $1, guest_email = $2, guest_phone = $3,
+        room_number = $4, room_type = $5, number_of_guests = $6,
+        check_in_date = $7, check_out_date = $8, number_of_nights = $9,
+        price_per_night = $10, total_price = $11, payment_method = $12,
+        paid = $13, reservation_status = $14, special_requests = $15,
+        updated_at = $16
+    WHERE id = $17
+)";
+
+constexpr const char* kDeleteReservationSql =
+    "DELETE FROM reservations WHERE id = $1";
+
+// Overlap test of overlappingReservations(): stays touching on a day
+// overlap, as in the constraint on the table. Served by
+// reservations_room_dates_idx.
+constexpr const char* kRoomOverlaps = "room_overlaps";
+constexpr const char* kRoomOverlapsSql = R"(
+    SELECT id FROM reservations
+    WHERE room_number = $1
+      AND check_in_date <= $3::date
+      AND check_out_date >= $2::date
+    ORDER BY check_in_date
+)";
+
+// Same test on a partitioned table: $4 is PartitionMaintainer::kMaxStayDays,
+// no overlapping stay starts earlier, so older partitions are pruned
+constexpr const char* kRoomOverlapsPartitioned = "room_overlaps_partitioned";
+constexpr const char* kRoomOverlapsPartitionedSql = R"(
+    SELECT id FROM reservations
+    WHERE room_number = $1
+      AND check_in_date <= $3::date
+      AND check_out_date >= $2::date
+      AND check_in_date >= $2::date - $4::int
+    ORDER BY check_in_date
+)";
+
+// searchReservations() and exportReservations() append their filters to this
+constexpr const char* kSearchReservationsSql = R"(
+    SELECT id, guest_name, guest_email, guest_phone,
+           room_number, room_type, number_of_guests,
+           check_in_date, check_out_date, number_of_nights,
+           price_per_night, total_price, payment_method, paid,
+           reservation_status, special_requests,
+           created_at, updated_at
+    FROM reservations
+    WHERE TRUE)";
+
+// Indexes ensureIndexes() maintains: room and dates (search by room,
+// availability), check-in date with ID (date searches, pages in date
+// order), and status with check-in date
+struct IndexDefinition {
+    const char* name;
+    const char* columns;
+};
+constexpr IndexDefinition kSearchIndexes[] = {
+    {"reservations_room_dates_idx",
+     "room_number, check_in_date, check_out_date"},
+    {"reservations_check_in_id_idx", "check_in_date, id"},
+    {"reservations_status_dates_idx", "reservation_status, check_in_date"},
+};
+
+// Appends the conditions of search's filters to query. bind(value) gives
+// the SQL standing for value: a placeholder, or a quoted literal. On a
+// partitioned table, from also bounds the partition key (isPartitioned()).
+template <typename Bind>
+void appendFilters(std::string& query, const ReservationSearch& search,
+                   bool partitioned, Bind&& bind) {
+    if (search.roomNumber) {
+        query += " AND room_number = " + bind(*search.roomNumber);
+    }
+    if (search.from) {
+        query += " AND check_out_date >= " + bind(*search.from) + "::date";
+    }
+    if (search.from && partitioned) {
+        query += " AND check_in_date >= " + bind(*search.from) + "::date";
+        query += " - " + bind(PartitionMaintainer::kMaxStayDays) + "::int";
+    }
+    if (search.to) {
+        query += " AND check_in_date <= " + bind(*search.to) + "::date";
+    }
+    if (search.status) {
+        query += " AND reservation_status = " + bind(*search.status);
+    }
+}
 
-    try {
-        // Step 1: Sanity check
-        if (!conn.is_open()) {
-            std::cerr << "[PostgresDB] ERROR: Connection lost" << std::endl;
-            return -1;
-        }
+// The 17 columns of kGetReservationSql, in its order, starting at column
+// first of row, into res (its strings keep their capacity). Search rows
+// carry the id before them.
+void readReservationRow(const pqxx::row& row, Reservation& res,
+                        int first = 0) {
+    res.guest_name = row[first].as<std::string>();
+    res.guest_email = row[first + 1].as<std::string>();
+    res.guest_phone = row[first + 2].as<std::string>();
+    res.room_number = row[first + 3].as<int>();
+    res.room_type = row[first + 4].as<std::string>();
+    res.number_of_guests = row[first + 5].as<int>();
+    res.check_in_date = row[first + 6].as<std::string>();
+    res.check_out_date = row[first + 7].as<std::string>();
+    res.number_of_nights = row[first + 8].as<int>();
+    res.price_per_night = row[first + 9].as<double>();
+    res.total_price = row[first + 10].as<double>();
+    res.payment_method = row[first + 11].as<std::string>();
+    res.paid = row[first + 12].as<bool>();
+    res.reservation_status = row[first + 13].as<std::string>();
+    res.special_requests = row[first + 14].as<std::string>();
+    res.created_at = row[first + 15].as<long>();
+    res.updated_at = row[first + 16].as<long>();
+}
 
-        /*
-         * Step 2: Create a transaction
-         *
-         * What is pqxx::work?
-         * - A transaction object
-         * - Everything you do with it (execute, insert, etc) is part of ONE
-         * transaction
-         * - If you commit() it, everything is saved
-         * - If you throw an exception before commit(), EVERYTHING is rolled
-         * back
-         * - This is all-or-nothing safety
-         *
-         */
-        pqxx::work txn(conn);
+// Parameters $1..$17 of the insert statements, in column order
+void appendInsertParams(pqxx::params& p, const Reservation& res) {
+    p.append(res.guest_name);
+    p.append(res.guest_email);
+    p.append(res.guest_phone);
+    p.append(res.room_number);
+    p.append(res.room_type);
+    p.append(res.number_of_guests);
+    p.append(res.check_in_date);
+    p.append(res.check_out_date);
+    p.append(res.number_of_nights);
+    p.append(res.price_per_night);
+    p.append(res.total_price);
+    p.append(res.payment_method);
+    p.append(res.paid);
+    p.append(res.reservation_status);
+    p.append(res.special_requests);
+    p.append(res.created_at);
+    p.append(res.updated_at);
+}
 
-        /*
-         * Step 3: Execute INSERT with prepared statement
-         *
-         * SQL prepared statement: INSERT with PLACEHOLDERS
-         * Placeholders: $1, $2, $3, ... $N
-         *
-         * Why placeholders instead of concatenating strings?
-         *
-         * DANGEROUS (vulnerable to SQL injection):
-         *   std::string query = "INSERT INTO reservations (guest_name) VALUES
-         * ('"
-         *                       + res.guest_name + "')";
-         *
-         * SAFE (protected by prepared statement):
-         *   std::string query = "INSERT INTO reservations (guest_name) VALUES
-         * ($1)"; txn.exec_params(query, res.guest_name);
-         *
-         *   libpqxx sends res.guest_name as DATA, not as SQL code.
-         *   Server knows: "this is a value, not code"
-         *   No injection possible.
-         */
+// Opens the block a pipelined batch of reads runs in: one snapshot for the
+// whole batch, and no write can slip into it
+constexpr const char* kBeginReadSnapshot =
+    "BEGIN ISOLATION LEVEL REPEATABLE READ READ ONLY";
 
-        // The INSERT statement with $1, $2, etc. placeholders
-        // RETURNING id allows us to get the assigned ID
-        std::string insertQuery = R"(
-            INSERT INTO reservations (
-                guest_name, guest_email, guest_phone,
-                room_number, room_type, number_of_guests,
-                check_in_date, check_out_date, number_of_nights,
-                price_per_night, total_price, payment_method, paid,
-                reservation_status, special_requests,
-                created_at, updated_at
-            ) VALUES (
-                $1, $2, $3,
-                $4, $5, $6,
-                $7, $8, $9,
-                $10, $11, $12, $13,
-                $14, $15,
-                $16, $17
-            )
-            RETURNING id
-        )";
+void expectCommandOk(const PipelinedConnection::Result& result,
+                     const char* statement) {
+    if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
+        throw std::runtime_error(std::string(statement) + " failed: " +
+                                 PQresultErrorMessage(result.get()));
+    }
+}
 
-        /*
-         * R"(...)" is a raw string literal
-         * Useful here because we have lots of quotes and newlines
-         * Without it, would need escaping: "INSERT ... WHERE name =
-         * \\"value\\"" With raw string: no escaping needed
-         */
+/*
+ * Executes statement once per item in a single pipeline. params(i) gives
+ * the parameters of item i, and onResult(i, result) receives its result,
+ * in order. At most kPipelineDepth statements are in flight: past that,
+ * results are read before sending more, so neither side blocks on a full
+ * socket buffer while the other is not reading.
+ *
+ * With sharedSnapshot, the statements run in one read-only REPEATABLE READ
+ * transaction, so they all see the database as of the first one. BEGIN and
+ * COMMIT travel in the same pipeline and add no round trip.
+ */
+template <typename Params, typename OnResult>
+void runPipelined(pqxx::connection& conn, const char* statement,
+                  std::size_t count, Params&& params, OnResult&& onResult,
+                  bool sharedSnapshot = false) {
+    if (count == 0) {
+        return;
+    }
+    PipelinedConnection pipeline(conn);
+    bool begun = !sharedSnapshot;
+    std::size_t received = 0;
+    auto readNext = [&] {
+        auto result = pipeline.nextResult();
+        if (!begun) {
+            expectCommandOk(result, "BEGIN");
+            begun = true;
+            return;
+        }
+        onResult(received, result.get());
+        received++;
+    };
+    if (sharedSnapshot) {
+        pipeline.sendQuery(kBeginReadSnapshot);
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        if (pipeline.pending() == PostgresDB::kPipelineDepth) {
+            readNext();
+        }
+        pipeline.sendPrepared(statement, params(i));
+    }
+    if (sharedSnapshot) {
+        pipeline.sendQuery("COMMIT");
+    }
+    while (received < count) {
+        readNext();
+    }
+    if (sharedSnapshot) {
+        expectCommandOk(pipeline.nextResult(), "COMMIT");
+    }
+}
 
-        // Execute with parameters using new pqxx API
-        pqxx::params p;
-        p.append(res.guest_name);
-        p.append(res.guest_email);
-        p.append(res.guest_phone);
-        p.append(res.room_number);
-        p.append(res.room_type);
-        p.append(res.number_of_guests);
-        p.append(res.check_in_date);
-        p.append(res.check_out_date);
-        p.append(res.number_of_nights);
-        p.append(res.price_per_night);
-        p.append(res.total_price);
-        p.append(res.payment_method);
-        p.append(res.paid);
-        p.append(res.reservation_status);
-        p.append(res.special_requests);
-        p.append(res.created_at);
-        p.append(res.updated_at);
-        auto result = txn.exec(insertQuery, p);
+}  // namespace
 
-        // Step 4: Commit the transaction
-        txn.commit();
+void PostgresDB::checkStay(const Reservation& res) const {
+    if (partitionMaintainer) {
+        partitionMaintainer->checkStay(res.check_in_date, res.check_out_date);
+    }
+}
 
-        /*
-         * - If commit succeeds, data is in database forever
-         * - If commit fails, all changes are rolled back automatically
-         */
+bool PostgresDB::setUpPartitioning(pqxx::connection& connection,
+                                   const ConfigManager& config) {
+    PartitionOptions options = partitionOptions(config);
+    if (options.monthsAhead > 0 &&
+        PartitionMaintainer::bootstrap(connection)) {
+        PartitionMaintainer::maintain(connection, options,
+                                      PartitionMaintainer::currentMonth());
+    }
+    return PartitionMaintainer::isPartitioned(connection);
+}
 
-        // Extract the returned ID
-        int assignedId = result[0][0].as<int>();
-        std::cout << "[PostgresDB] Reservation inserted successfully for: "
-                  << res.guest_name << " with ID: " << assignedId << std::endl;
+ConnectionPoolOptions PostgresDB::buildPoolOptions(
+    const ConfigManager& config) {
+    using std::chrono::milliseconds;
+    ConnectionPoolOptions options;
+    options.minSize = intSetting(config, "DB_POOL_MIN",
+                                 static_cast<int>(options.minSize), 0);
+    options.maxSize = intSetting(config, "DB_POOL_MAX",
+                                 static_cast<int>(options.maxSize), 1);
+    if (options.minSize > options.maxSize) {
+        throw std::invalid_argument(
+            "Invalid pool size: DB_POOL_MIN=" +
+            std::to_string(options.minSize) + " is greater than DB_POOL_MAX=" +
+            std::to_string(options.maxSize));
+    }
+    options.idleTimeout = milliseconds(
+        intSetting(config, "DB_POOL_IDLE_TIMEOUT_MS",
+                   static_cast<int>(options.idleTimeout.count()), 0));
+    options.acquireTimeout = milliseconds(
+        intSetting(config, "DB_POOL_ACQUIRE_TIMEOUT_MS",
+                   static_cast<int>(options.acquireTimeout.count()), 1));
+    options.validateAfterIdle = milliseconds(
+        intSetting(config, "DB_POOL_VALIDATE_AFTER_IDLE_MS",
+                   static_cast<int>(options.validateAfterIdle.count()), 0));
+    options.onConnect = prepareStatements;
+    return options;
+}
 
-        return assignedId;
+void PostgresDB::prepareStatements(pqxx::connection& connection) {
+    connection.prepare(kInsertReservation, kInsertReservationSql);
+    connection.prepare(kGetReservation, kGetReservationSql);
+    connection.prepare(kUpdateReservation, kUpdateReservationSql);
+    connection.prepare(kDeleteReservation, kDeleteReservationSql);
+    connection.prepare(kRoomOverlaps, kRoomOverlapsSql);
+    connection.prepare(kRoomOverlapsPartitioned, kRoomOverlapsPartitionedSql);
+}
 
+void PostgresDB::ensureIndexes(pqxx::connection& connection) {
+    // Not available on a partitioned table, whose index is only a template
+    // for those of its partitions: built there while a partition is small
+    std::string concurrently = " CONCURRENTLY ";
+    try {
+        pqxx::nontransaction txn(connection);
+        auto kind = txn.exec(
+            "SELECT relkind FROM pg_class "
+            "WHERE oid = to_regclass('reservations')");
+        if (!kind.empty() && kind[0][0].as<std::string>() == "p") {
+            concurrently = " ";
+        }
     } catch (const std::exception& e) {
-        /*
-         * If ANY step above throws:
-         * - Transaction is automatically rolled back (no partial inserts)
-         * - Exception caught here
-         * - Return -1 to caller
-         *
-         * This is the safety of RAII + transactions
-         */
-        std::cerr << "[PostgresDB] Error inserting reservation: " << e.what()
+        std::cerr << "[PostgresDB] Cannot inspect reservations: " << e.what()
                   << std::endl;
-        return -1;
+    }
+    for (const IndexDefinition& index : kSearchIndexes) {
+        try {
+            // CONCURRENTLY cannot run inside a transaction block
+            pqxx::nontransaction txn(connection);
+            pqxx::params p;
+            p.append(std::string(index.name));
+            auto result = txn.exec(R"(
+                SELECT i.indisvalid
+                FROM pg_index i JOIN pg_class c ON c.oid = i.indexrelid
+                WHERE c.relname = $1
+                  AND c.relnamespace = to_regnamespace(current_schema())
+            )",
+                                   p);
+            if (!result.empty() && result[0][0].as<bool>()) {
+                continue;
+            }
+            if (!result.empty()) {
+                std::cerr << "[PostgresDB] Rebuilding invalid index "
+                          << index.name << std::endl;
+                txn.exec("DROP INDEX" + concurrently + index.name);
+            }
+            std::cout << "[PostgresDB] Creating index " << index.name
+                      << std::endl;
+            txn.exec("CREATE INDEX" + concurrently + index.name +
+                     " ON reservations (" + index.columns + ")");
+        } catch (const std::exception& e) {
+            std::cerr << "[PostgresDB] Cannot ensure index " << index.name
+                      << ", searches will be slower: " << e.what()
+                      << std::endl;
+        }
     }
 }
 
+bool PostgresDB::isConnected() const { return conn.is_open(); }
+
+int PostgresDB::insertReservation(const Reservation& res) {
+    return insertReservation(conn, res);
+}
+
 int PostgresDB::insertReservation(pqxx::connection& conn,
                                   const Reservation& res) {
     /*
@@ -250,44 +616,11 @@ int PostgresDB::insertReservation(pqxx::connection& conn,
 
         pqxx::work txn(conn);
 
-        std::string insertQuery = R"(
-            INSERT INTO reservations (
-                guest_name, guest_email, guest_phone,
-                room_number, room_type, number_of_guests,
-                check_in_date, check_out_date, number_of_nights,
-                price_per_night, total_price, payment_method, paid,
-                reservation_status, special_requests,
-                created_at, updated_at
-            ) VALUES (
-                $1, $2, $3,
-                $4, $5, $6,
-                $7, $8, $9,
-                $10, $11, $12, $13,
-                $14, $15,
-                $16, $17
-            )
-            RETURNING id
-        )";
-
         pqxx::params p;
-        p.append(res.guest_name);
-        p.append(res.guest_email);
-        p.append(res.guest_phone);
-        p.append(res.room_number);
-        p.append(res.room_type);
-        p.append(res.number_of_guests);
-        p.append(res.check_in_date);
-        p.append(res.check_out_date);
-        p.append(res.number_of_nights);
-        p.append(res.price_per_night);
-        p.append(res.total_price);
-        p.append(res.payment_method);
-        p.append(res.paid);
-        p.append(res.reservation_status);
-        p.append(res.special_requests);
-        p.append(res.created_at);
-        p.append(res.updated_at);
-        auto result = txn.exec(insertQuery, p);
+        appendInsertParams(p, res);
+        // Prepared by prepareStatements(): only the values travel, the
+        // server reuses the statement it parsed when the connection opened
+        auto result = txn.exec(pqxx::prepped{kInsertReservation}, p);
 
         txn.commit();
 
@@ -305,7 +638,64 @@ int PostgresDB::insertReservation(pqxx::connection& conn,
     }
 }
 
+std::vector<int> PostgresDB::insertReservations(
+    pqxx::connection& conn, const std::vector<const Reservation*>& batch) {
+    if (batch.empty()) {
+        return {};
+    }
+    if (batch.size() > kMaxInsertBatch) {
+        throw std::invalid_argument("insertReservations: batch of " +
+                                    std::to_string(batch.size()) +
+                                    " rows, at most " +
+                                    std::to_string(kMaxInsertBatch));
+    }
+
+    pqxx::work txn(conn);
+    // Each row gets its ID in the VALUES list, so the ID handed back for
+    // batch[i] does not depend on the order RETURNING would list the rows
+    std::vector<int> ids = drawReservationIds(txn, batch.size());
+
+    std::string query = kInsertBatchPrefix;
+    query.reserve(query.size() + batch.size() * kInsertColumns * 6);
+    pqxx::params p;
+    std::size_t placeholder = 1;
+    for (std::size_t row = 0; row < batch.size(); row++) {
+        query += row == 0 ? "(" : ", (";
+        for (std::size_t column = 0; column < kInsertColumns; column++) {
+            if (column > 0) {
+                query += ", ";
+            }
+            query += '$';
+            query += std::to_string(placeholder++);
+        }
+        query += ')';
+        p.append(ids[row]);
+        appendInsertParams(p, *batch[row]);
+    }
+
+    txn.exec(query, p);
+    txn.commit();
+    return ids;
+}
+
+std::vector<int> PostgresDB::drawReservationIds(pqxx::transaction_base& txn,
+                                                std::size_t count) {
+    pqxx::params p;
+    p.append(static_cast<long>(count));
+    auto drawn = txn.exec(kDrawIdsSql, p);
+    std::vector<int> ids;
+    ids.reserve(drawn.size());
+    for (const auto& row : drawn) {
+        ids.push_back(row[0].as<int>());
+    }
+    return ids;
+}
+
 Reservation PostgresDB::getReservationById(int id) {
+    return getReservationById(conn, id);
+}
+
+Reservation PostgresDB::getReservationById(pqxx::connection& conn, int id) {
     /*
      * Purpose: SELECT a reservation from database, return as C++ object
      *
@@ -321,25 +711,14 @@ Reservation PostgresDB::getReservationById(int id) {
             throw std::runtime_error("Connection lost");
         }
 
-        // For SELECT, use pqxx::work (same as INSERT)
-        pqxx::work txn(conn);
-
-        // SELECT query with $1 placeholder for ID
-        std::string selectQuery = R"(
-            SELECT guest_name, guest_email, guest_phone,
-                   room_number, room_type, number_of_guests,
-                   check_in_date, check_out_date, number_of_nights,
-                   price_per_night, total_price, payment_method, paid,
-                   reservation_status, special_requests,
-                   created_at, updated_at
-            FROM reservations
-            WHERE id = $1
-        )";
+        // A single SELECT runs in its own implicit transaction: no BEGIN
+        // and COMMIT round trips around it
+        pqxx::nontransaction txn(conn);
 
         // Execute with ID parameter using new pqxx API
         pqxx::params p;
         p.append(id);
-        auto result = txn.exec(selectQuery, p);
+        auto result = txn.exec(pqxx::prepped{kGetReservation}, p);
 
         /*
          * exec_params returns a result set
@@ -350,8 +729,8 @@ Reservation PostgresDB::getReservationById(int id) {
          */
 
         if (result.empty()) {
-            throw std::runtime_error("Reservation with ID " +
-                                     std::to_string(id) + " not found");
+            throw ReservationNotFound("Reservation with ID " +
+                                      std::to_string(id) + " not found");
         }
 
         // Get the first row
@@ -359,29 +738,7 @@ Reservation PostgresDB::getReservationById(int id) {
 
         // Create Reservation object from row data
         Reservation res;
-        // guest contact information
-        res.guest_name = row[0].as<std::string>();
-        res.guest_email = row[1].as<std::string>();
-        res.guest_phone = row[2].as<std::string>();
-        // room information
-        res.room_number = row[3].as<int>();
-        res.room_type = row[4].as<std::string>();
-        res.number_of_guests = row[5].as<int>();
-        // dates information
-        res.check_in_date = row[6].as<std::string>();
-        res.check_out_date = row[7].as<std::string>();
-        res.number_of_nights = row[8].as<int>();
-        // price and payment information
-        res.price_per_night = row[9].as<double>();
-        res.total_price = row[10].as<double>();
-        res.payment_method = row[11].as<std::string>();
-        res.paid = row[12].as<bool>();
-        // extra information of the reservation
-        res.reservation_status = row[13].as<std::string>();
-        res.special_requests = row[14].as<std::string>();
-        res.created_at = row[15].as<long>();
-        res.updated_at = row[16].as<long>();
-        txn.commit();
+        readReservationRow(row, res);
         return res;
 
     } catch (const std::exception& e) {
@@ -392,6 +749,11 @@ Reservation PostgresDB::getReservationById(int id) {
 }
 
 bool PostgresDB::updateReservation(int id, const Reservation& res) {
+    return updateReservation(conn, id, res);
+}
+
+bool PostgresDB::updateReservation(pqxx::connection& conn, int id,
+                                   const Reservation& res) {
     /*
      * Uses WHERE clause to target specific row
      */
@@ -403,17 +765,6 @@ bool PostgresDB::updateReservation(int id, const Reservation& res) {
 
         pqxx::work txn(conn);
 
-        std::string updateQuery = R"(
-            UPDATE reservations SET
-                guest_name = $1, guest_email = $2, guest_phone = $3,
-                room_number = $4, room_type = $5, number_of_guests = $6,
-                check_in_date = $7, check_out_date = $8, number_of_nights = $9,
-                price_per_night = $10, total_price = $11, payment_method = $12, paid = $13,
-                reservation_status = $14, special_requests = $15,
-                updated_at = $16
-            WHERE id = $17
-        )";
-
         pqxx::params p;
         p.append(res.guest_name);
         p.append(res.guest_email);
@@ -433,7 +784,7 @@ bool PostgresDB::updateReservation(int id, const Reservation& res) {
         p.append(res.updated_at);
         p.append(id);
 
-        pqxx::result result = txn.exec(updateQuery, p);
+        pqxx::result result = txn.exec(pqxx::prepped{kUpdateReservation}, p);
 
         txn.commit();
 
@@ -457,6 +808,10 @@ bool PostgresDB::updateReservation(int id, const Reservation& res) {
 }
 
 bool PostgresDB::deleteReservation(int id) {
+    return deleteReservation(conn, id);
+}
+
+bool PostgresDB::deleteReservation(pqxx::connection& conn, int id) {
     try {
         if (!conn.is_open()) {
             return false;
@@ -464,11 +819,9 @@ bool PostgresDB::deleteReservation(int id) {
 
         pqxx::work txn(conn);
 
-        std::string deleteQuery = "DELETE FROM reservations WHERE id = $1";
-
         pqxx::params p;
         p.append(id);
-        pqxx::result result = txn.exec(deleteQuery, p);
+        pqxx::result result = txn.exec(pqxx::prepped{kDeleteReservation}, p);
 
         txn.commit();
 
@@ -489,3 +842,152 @@ bool PostgresDB::deleteReservation(int id) {
         return false;
     }
 }
+
+std::vector<StoredReservation> PostgresDB::searchReservations(
+    pqxx::connection& conn, const ReservationSearch& search) {
+    std::vector<StoredReservation> found;
+    visitReservations(conn, search,
+                      [&found](int id, const Reservation& res) {
+                          found.push_back({id, res});
+                      });
+    return found;
+}
+
+std::optional<ReservationKey> PostgresDB::visitReservations(
+    pqxx::connection& conn, const ReservationSearch& search,
+    const std::function<void(int, const Reservation&)>& visit) {
+    if (search.limit == 0 || search.limit > kMaxSearchLimit) {
+        throw std::invalid_argument(
+            "Invalid search limit: " + std::to_string(search.limit) +
+            ". It must be between 1 and " + std::to_string(kMaxSearchLimit));
+    }
+    // Only the filters in use appear in the SQL, so each combination gets
+    // a plan that uses its index
+    std::string query = kSearchReservationsSql;
+    pqxx::params p;
+    int placeholder = 1;
+    auto bind = [&](const auto& value) {
+        p.append(value);
+        return "$" + std::to_string(placeholder++);
+    };
+    appendFilters(query, search, partitioned, bind);
+    bool byDate = search.order == ReservationOrder::CheckInDate;
+    if (search.after && byDate) {
+        // Row comparison: one range scan of reservations_check_in_id_idx
+        query += " AND (check_in_date, id) > (" +
+                 bind(search.after->checkInDate);
+        query += "::date, " + bind(search.after->id) + ")";
+    } else if (search.after) {
+        query += " AND id > " + bind(search.after->id);
+    }
+    query += byDate ? " ORDER BY check_in_date, id" : " ORDER BY id";
+    // One row more than the page tells whether another page follows
+    query += " LIMIT " + bind(static_cast<long>(search.limit + 1));
+
+    pqxx::nontransaction txn(conn);
+    auto result = txn.exec(query, p);
+
+    // pqxx sizes are signed
+    auto found = static_cast<std::size_t>(result.size());
+    std::size_t rows = std::min(found, search.limit);
+    Reservation res;
+    for (std::size_t i = 0; i < rows; i++) {
+        readReservationRow(result[i], res, 1);
+        visit(result[i][0].as<int>(), res);
+    }
+    if (found <= search.limit) {
+        return std::nullopt;
+    }
+    ReservationKey last;
+    last.id = result[rows - 1][0].as<int>();
+    if (byDate) {
+        last.checkInDate = res.check_in_date;
+    }
+    return last;
+}
+
+std::unique_ptr<ReservationExport> PostgresDB::exportReservations(
+    ConnectionPool::Lease conn, const ReservationSearch& search,
+    ExportFormat format) {
+    // COPY takes no parameters: the filters are quoted literals
+    std::string select = kSearchReservationsSql;
+    appendFilters(select, search, partitioned, [&conn](const auto& value) {
+        return conn->quote(value);
+    });
+    select += " ORDER BY id";
+
+    std::string copySql =
+        format == ExportFormat::Csv
+            ? "COPY (" + select + ") TO STDOUT WITH (FORMAT csv, HEADER)"
+            : "COPY (SELECT row_to_json(r) FROM (" + select +
+                  ") r) TO STDOUT";
+    return std::make_unique<ReservationExport>(std::move(conn), copySql,
+                                               format);
+}
+
+std::vector<int> PostgresDB::overlappingReservations(pqxx::connection& conn,
+                                                     int roomNumber,
+                                                     const std::string& from,
+                                                     const std::string& to) {
+    pqxx::nontransaction txn(conn);
+    pqxx::params p;
+    p.append(roomNumber);
+    p.append(from);
+    p.append(to);
+    if (partitioned) {
+        p.append(PartitionMaintainer::kMaxStayDays);
+    }
+    auto result = txn.exec(
+        pqxx::prepped{partitioned ? kRoomOverlapsPartitioned : kRoomOverlaps},
+        p);
+
+    std::vector<int> ids;
+    ids.reserve(result.size());
+    for (const auto& row : result) {
+        ids.push_back(row[0].as<int>());
+    }
+    return ids;
+}
+
+std::vector<std::optional<Reservation>> PostgresDB::getReservationsById(
+    pqxx::connection& conn, const std::vector<int>& ids) {
+    std::vector<std::optional<Reservation>> reservations(ids.size());
+    runPipelined(
+        conn, kGetReservation, ids.size(),
+        [&ids](std::size_t i) {
+            return std::vector<std::string>{pqxx::to_string(ids[i])};
+        },
+        [&](std::size_t i, PGresult* result) {
+            if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+                throw std::runtime_error(
+                    "Error retrieving reservation " + std::to_string(ids[i]) +
+                    ": " + PQresultErrorMessage(result));
+            }
+            if (PQntuples(result) > 0) {
+                reservations[i] = reservationFromResult(result);
+            }
+        },
+        true);
+    return reservations;
+}
+
+std::vector<bool> PostgresDB::updateReservations(
+    pqxx::connection& conn,
+    const std::vector<std::pair<int, Reservation>>& updates) {
+    std::vector<bool> updated(updates.size(), false);
+    runPipelined(
+        conn, kUpdateReservation, updates.size(),
+        [&updates](std::size_t i) {
+            return updateParams(updates[i].first, updates[i].second);
+        },
+        [&](std::size_t i, PGresult* result) {
+            if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+                std::cerr << "[PostgresDB] Error updating reservation "
+                          << updates[i].first << ": "
+                          << PQresultErrorMessage(result) << std::endl;
+                return;
+            }
+            updated[i] = std::string_view(PQcmdTuples(result)) != "0";
+        });
+    return updated;
+}
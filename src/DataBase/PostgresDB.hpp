@@ -1,16 +1,61 @@
 #ifndef POSTGRESDB_HPP
 #define POSTGRESDB_HPP
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <pqxx/pqxx>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "../HTTP/JsonHandler.hpp"
 #include "../Utils/ConnectionPool.hpp"
+#include "InsertBatcher.hpp"
+#include "PartitionMaintainer.hpp"
+#include "ReadRouting.hpp"
+#include "ReservationExport.hpp"
 
 // Forward declaration to avoid circular includes
 class ConfigManager;
 
+// Sort orders of PostgresDB::searchReservations(); ties on the date are
+// broken by ID, so every order is total
+enum class ReservationOrder { Id, CheckInDate };
+
+// Sort key of a row: where the next page of a search starts
+struct ReservationKey {
+    int id = 0;
+    // YYYY-MM-DD; only used by ReservationOrder::CheckInDate
+    std::string checkInDate;
+};
+
+// Filters of PostgresDB::searchReservations(); the ones left empty match
+// every reservation
+struct ReservationSearch {
+    std::optional<int> roomNumber;
+    // Stays overlapping the days from..to (YYYY-MM-DD, both included);
+    // either bound may be left open
+    std::optional<std::string> from;
+    std::optional<std::string> to;
+    std::optional<std::string> status;
+    ReservationOrder order = ReservationOrder::Id;
+    // Only rows sorting after this key (keyset pagination)
+    std::optional<ReservationKey> after;
+    // Rows returned at most
+    std::size_t limit = 100;
+};
+
+// No reservation has the ID looked up. Any other error of a lookup is a
+// database failure (pqxx::failure and its subclasses, Connection lost).
+class ReservationNotFound : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
 /*
  * PostgresDB.hpp
  *
@@ -28,6 +73,23 @@ class ConfigManager;
 
 class PostgresDB {
    public:
+    // Rows per insertReservations() call: 18 parameters per row must stay
+    // well below PostgreSQL's 65535 parameters per statement
+    static constexpr std::size_t kMaxInsertBatch = 1000;
+
+    // Statements a pipelined batch keeps in flight before reading results
+    static constexpr std::size_t kPipelineDepth = 128;
+
+    // Largest ReservationSearch::limit
+    static constexpr std::size_t kMaxSearchLimit = 1000;
+
+    // Names of the statements prepareStatements() prepares on every
+    // connection, for callers that execute them through libpq directly
+    static constexpr const char* kInsertReservation = "insert_reservation";
+    static constexpr const char* kGetReservation = "get_reservation";
+    static constexpr const char* kUpdateReservation = "update_reservation";
+    static constexpr const char* kDeleteReservation = "delete_reservation";
+
     /**
      * Constructor: Establishes connection to PostgreSQL database
      *
@@ -86,15 +148,51 @@ class PostgresDB {
      * pool Allows multiple threads to insert concurrently without blocking
      */
     int insertReservation(pqxx::connection& conn, const Reservation& res);
-    // TODO: pqxx connection in update, get and delete functions
+
+    /**
+     * Insert several reservations with one multi-row INSERT
+     *
+     * param: conn - Reference to a connection from ConnectionPool
+     * param: batch - at most kMaxInsertBatch reservations
+     * return: assigned IDs, in batch order: drawn first and inserted
+     *         explicitly, so ids[i] is the ID of batch[i]
+     * throws: if any row is rejected; the transaction is rolled back and
+     *         none of the rows is inserted
+     *
+     * Used by: InsertBatcher, so concurrent POSTs share one commit
+     */
+    std::vector<int> insertReservations(
+        pqxx::connection& conn, const std::vector<const Reservation*>& batch);
+
+    /**
+     * Draw count IDs from the reservations id sequence, for rows inserted
+     * with an explicit id. nextval() takes no lock; drawn IDs are not given
+     * back if txn rolls back.
+     *
+     * return: count distinct IDs, not necessarily consecutive
+     */
+    static std::vector<int> drawReservationIds(pqxx::transaction_base& txn,
+                                               std::size_t count);
+
     /**
      * Retrieve a reservation by ID
      *
      * param: id - reservation ID
      * return: Reservation object if found
-     * throws: std::runtime_error if no reservation with that ID exists
+     * throws: ReservationNotFound if no reservation with that ID exists,
+     *         another std::runtime_error if the database fails
      */
     Reservation getReservationById(int id);
+
+    /**
+     * Retrieve a reservation by ID using a connection from the pool
+     *
+     * Same contract as getReservationById(id). Worker threads pass their
+     * own connection, so reads run in parallel instead of queueing on the
+     * primary connection.
+     */
+    Reservation getReservationById(pqxx::connection& conn, int id);
+
     /**
      * Update an existing reservation
      *
@@ -104,6 +202,14 @@ class PostgresDB {
      */
     bool updateReservation(int id, const Reservation& res);
 
+    /**
+     * Update an existing reservation using a connection from the pool
+     *
+     * Same contract as updateReservation(id, res)
+     */
+    bool updateReservation(pqxx::connection& conn, int id,
+                           const Reservation& res);
+
     /**
      * Delete a reservation by ID
      *
@@ -112,6 +218,113 @@ class PostgresDB {
      */
     bool deleteReservation(int id);
 
+    /**
+     * Delete a reservation by ID using a connection from the pool
+     *
+     * Same contract as deleteReservation(id)
+     */
+    bool deleteReservation(pqxx::connection& conn, int id);
+
+    /**
+     * Retrieve several reservations in one pipeline (libpq pipeline mode)
+     *
+     * param: conn - Reference to a connection from ConnectionPool
+     * param: ids - reservation IDs, any number
+     * return: one entry per ID, in order; std::nullopt where no reservation
+     *         has that ID
+     * throws: if the connection fails or a lookup is rejected
+     *
+     * The SELECTs are sent back to back and their results read afterwards,
+     * so the batch waits about one round trip instead of one per ID. They
+     * run in one read-only REPEATABLE READ transaction, so they all see
+     * the same snapshot: no write lands between two lookups of a batch.
+     */
+    std::vector<std::optional<Reservation>> getReservationsById(
+        pqxx::connection& conn, const std::vector<int>& ids);
+
+    /**
+     * Update several reservations in one pipeline
+     *
+     * param: conn - Reference to a connection from ConnectionPool
+     * param: updates - (id, new data) pairs, any number
+     * return: one entry per update, in order, as updateReservation()
+     *         would return it
+     * throws: if the connection fails
+     *
+     * Each UPDATE commits on its own: one that fails (e.g. an overlapping
+     * stay) does not undo or stop the others.
+     */
+    std::vector<bool> updateReservations(
+        pqxx::connection& conn,
+        const std::vector<std::pair<int, Reservation>>& updates);
+
+    /**
+     * Find reservations by room, stay dates and status
+     *
+     * param: conn - Reference to a connection from ConnectionPool
+     * param: search - filters; limit at most kMaxSearchLimit
+     * return: matching reservations with their IDs, in search.order
+     * throws: std::invalid_argument on a limit out of range, or the
+     *         database error (e.g. a malformed date)
+     *
+     * Served by the indexes ensureIndexes() creates, not a table scan.
+     */
+    std::vector<StoredReservation> searchReservations(
+        pqxx::connection& conn, const ReservationSearch& search);
+
+    /**
+     * Same search, handing each row to visit instead of collecting them
+     *
+     * param: visit - called with the ID and the reservation of each row,
+     *        in order; the reservation is reused for the next row
+     * return: key of the last row visited when more rows match, to pass as
+     *         search.after for the next page; std::nullopt on the last page
+     *
+     * A page is a range scan of an index from search.after on, (key, id) >
+     * (last key, last id), never an OFFSET: every page costs the same, the
+     * ten-thousandth as much as the first.
+     */
+    std::optional<ReservationKey> visitReservations(
+        pqxx::connection& conn, const ReservationSearch& search,
+        const std::function<void(int, const Reservation&)>& visit);
+
+    /**
+     * Start exporting every reservation matching search, by ID
+     *
+     * param: conn - leased connection, handed to the export, which holds
+     *        it until destroyed
+     * param: search - filters; order, after and limit are ignored
+     * param: format - CSV with a header line, or NDJSON with the fields of
+     *        a GET response plus "id"
+     * return: the export, to read to the end or destroy to cancel it
+     * throws: std::runtime_error if the query fails
+     *
+     * The rows come from COPY ... TO STDOUT: PostgreSQL formats them and
+     * sends them as one stream, which the export reads as it goes, so the
+     * result set is never held in memory on either side.
+     */
+    std::unique_ptr<ReservationExport> exportReservations(
+        ConnectionPool::Lease conn, const ReservationSearch& search,
+        ExportFormat format);
+
+    /**
+     * Reservations of a room that a stay from..to would overlap
+     *
+     * param: conn - Reference to a connection from ConnectionPool
+     * param: roomNumber - room to check
+     * param: from, to - first and last day (YYYY-MM-DD) of the stay
+     * return: IDs of the overlapping reservations, by check-in date; empty
+     *         when the room is available
+     *
+     * Same rule as the constraint that rejects overlapping inserts: a
+     * check-out on the day of the next check-in overlaps. Reservations of
+     * any status count.
+     */
+    std::vector<int> overlappingReservations(pqxx::connection& conn,
+                                             int roomNumber,
+                                             const std::string& from,
+                                             const std::string& to);
+
     /**
      * Get access to connection pool
      *
@@ -120,6 +333,136 @@ class PostgresDB {
      */
     ConnectionPool* getConnectionPool() const;
 
+    /**
+     * Pool of read replica connections, enabled by DB_READ_HOST
+     *
+     * return: nullptr when reads are not routed to a replica
+     */
+    ConnectionPool* getReadPool() const;
+
+    /**
+     * Record a write by a client (e.g. its address), whose reads then go
+     * to the primary for DB_READ_YOUR_WRITES_MS so they see the write
+     * even if the replica lags behind. No-op for an empty client.
+     */
+    void noteWrite(std::string_view client);
+
+    /**
+     * Whether withReadConnection() sends the reads of client to the
+     * replica. Such a read may return a version the primary has already
+     * replaced, or fall back to the primary.
+     */
+    bool readsFromReplica(std::string_view client) const {
+        return readPool && !recentWriters.wroteRecently(client);
+    }
+
+    /**
+     * How far the replica is assumed to lag behind at most:
+     * DB_READ_YOUR_WRITES_MS, the time writers stay on the primary
+     */
+    std::chrono::milliseconds replicaLagBound() const {
+        return recentWriters.getWindow();
+    }
+
+    /**
+     * Run a read-only operation on a leased connection, on the replica
+     * when one is configured
+     *
+     * param: client - who reads, as passed to noteWrite(); empty for none
+     * param: read - callable taking a pqxx::connection&; must not write
+     * return: what read returns
+     * throws: what read throws, or PoolUnavailable from the primary pool
+     *
+     * The read goes to the primary when there is no replica or the client
+     * wrote recently. When the replica cannot hand out a connection or
+     * loses it mid-read, the read is retried once on the primary.
+     */
+    template <typename Read>
+    auto withReadConnection(std::string_view client, Read&& read) {
+        if (readsFromReplica(client)) {
+            try {
+                auto conn = readPool->acquire();
+                auto result = read(*conn);
+                replicaReads++;
+                return result;
+            } catch (const PoolUnavailable& e) {
+                noteFallback(e);
+            } catch (const pqxx::broken_connection& e) {
+                noteFallback(e);
+            }
+        } else if (readPool) {
+            primaryReads++;
+        }
+        auto conn = pool.acquire();
+        return read(*conn);
+    }
+
+    /**
+     * Lease a connection for a read that outlives a call, e.g. an export,
+     * routed as withReadConnection() routes its reads
+     *
+     * throws: PoolUnavailable from the primary pool
+     *
+     * Only a replica that cannot hand out a connection falls back to the
+     * primary here: one lost mid-read fails the read.
+     */
+    ConnectionPool::Lease acquireReadConnection(std::string_view client);
+
+    // Counters of withReadConnection(); all zero without a replica
+    ReadRoutingStats readRoutingStats() const;
+
+    /**
+     * Group-commit inserter, enabled by DB_INSERT_BATCH_SIZE > 1
+     *
+     * return: nullptr when inserts are not batched
+     */
+    InsertBatcher* getInsertBatcher() const;
+
+    /**
+     * Whether reservations is partitioned by PartitionMaintainer (enabled
+     * by DB_PARTITION_MONTHS_AHEAD > 0, or done by another server)
+     *
+     * Stays are then at most PartitionMaintainer::kMaxStayDays long, and
+     * the date searches and the availability check also bound the check-in
+     * date from below with it, so only the partitions of the months in
+     * range are scanned. Lookups by ID alone cannot be pruned: they probe
+     * the primary key index of every partition.
+     */
+    bool isPartitioned() const { return partitioned; }
+
+    /**
+     * Refuse a stay the partitions of this server cannot hold, before it
+     * reaches the database (see PartitionMaintainer::checkStay). No-op
+     * unless this server maintains the partitions.
+     *
+     * throws: StayOutsidePartitions
+     */
+    void checkStay(const Reservation& res) const;
+
+    /**
+     * Prepare the reservation statements on a connection
+     *
+     * Run once per connection (the primary one, and every pool connection
+     * through ConnectionPoolOptions::onConnect). The operations above then
+     * execute them by name, so PostgreSQL does not parse and plan the SQL
+     * text again on every call.
+     */
+    static void prepareStatements(pqxx::connection& connection);
+
+    /**
+     * Create the search indexes, or check that they exist and are valid
+     *
+     * Run once at startup on the primary connection. A missing index is
+     * built with CREATE INDEX CONCURRENTLY, so writes go on meanwhile; an
+     * invalid one (left by an interrupted build) is dropped and rebuilt.
+     * On a partitioned table, which has no CONCURRENTLY, the index is
+     * created on the parent, and every partition gets its own, new ones
+     * included.
+     * Errors such as missing privileges are logged, not thrown: searches
+     * still work, only slower.
+     */
+    static void ensureIndexes(pqxx::connection& connection);
+
    private:
     /**
      * The actual database connection object (provided by libpqxx)
@@ -127,16 +470,50 @@ class PostgresDB {
      */
     pqxx::connection conn;
 
+    // See isPartitioned(). Set up on conn before pool opens its
+    // connections: preparing the statements needs the table.
+    bool partitioned;
+
     /**
      * Connection pool for multi-threaded access
      *
-     * - Maintains 4 database connections
-     * - Worker threads acquire/release connections via this pool
+     * - Keeps DB_POOL_MIN connections open, grows to DB_POOL_MAX while all
+     *   are in use and closes the extra ones after DB_POOL_IDLE_TIMEOUT_MS
+     * - Worker threads lease connections from this pool; a lease returns
+     *   its connection when destroyed, broken ones are reconnected
      * - Thread-safe: protected by mutex and condition_variable
      * - Shared resource: all ClientConnection threads use this same pool
      */
     mutable ConnectionPool pool;
 
+    /**
+     * Optional insert batching (see getInsertBatcher)
+     *
+     * Declared after pool: it is destroyed first, and writes its pending
+     * rows with pool connections while doing so.
+     */
+    std::unique_ptr<InsertBatcher> insertBatcher;
+
+    // Creates and archives partitions while partitioning is enabled.
+    // Declared after pool, which it leases from.
+    std::unique_ptr<PartitionMaintainer> partitionMaintainer;
+
+    /**
+     * Optional read replica (see getReadPool), with the same credentials
+     * and database name as the primary
+     */
+    std::unique_ptr<ConnectionPool> readPool;
+
+    // Clients whose reads stay on the primary (see noteWrite)
+    RecentWriters recentWriters;
+
+    std::atomic<std::uint64_t> replicaReads{0};
+    std::atomic<std::uint64_t> primaryReads{0};
+    std::atomic<std::uint64_t> fallbacks{0};
+
+    // Counts and logs a replica read retried on the primary
+    void noteFallback(const std::exception& error);
+
     /**
      * Build PostgreSQL connection string from ConfigManager
      *
@@ -148,6 +525,36 @@ class PostgresDB {
      * It's an implementation detail, not part of the public interface.
      */
     static std::string buildConnectionString(const ConfigManager& config);
+
+    /**
+     * Connection string of the read replica: DB_READ_HOST and
+     * DB_READ_PORT (default DB_PORT), other settings as the primary
+     */
+    static std::string buildReadConnectionString(const ConfigManager& config);
+
+    /**
+     * Read the optional pool tuning keys, defaults from ConnectionPoolOptions
+     *
+     * DB_POOL_MIN, DB_POOL_MAX - connections kept open / upper bound
+     * DB_POOL_IDLE_TIMEOUT_MS - idle time before a connection above the
+     *   minimum is closed (0 = never)
+     * DB_POOL_ACQUIRE_TIMEOUT_MS - longest wait for a free connection
+     * DB_POOL_VALIDATE_AFTER_IDLE_MS - idle time after which a connection is
+     *   pinged before being handed out
+     * throws: std::invalid_argument on out of range values
+     */
+    static ConnectionPoolOptions buildPoolOptions(const ConfigManager& config);
+
+    /**
+     * With DB_PARTITION_MONTHS_AHEAD > 0, create the partitioned table if
+     * there is none and run a first maintenance pass, so the partitions
+     * exist before the server takes requests
+     *
+     * return: whether reservations is partitioned
+     * throws: on invalid partition settings or a failed bootstrap
+     */
+    static bool setUpPartitioning(pqxx::connection& connection,
+                                  const ConfigManager& config);
 };
 
 #endif  // POSTGRESDB_HPP
@@ -0,0 +1,31 @@
+#include "ReadRouting.hpp"
+
+void RecentWriters::noteWrite(std::string_view client) {
+    if (client.empty() || window.count() == 0) {
+        return;
+    }
+    auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(mtx);
+    lastWrite.insert_or_assign(std::string(client), now);
+    if (now < nextPrune) {
+        return;
+    }
+    for (auto entry = lastWrite.begin(); entry != lastWrite.end();) {
+        if (now - entry->second >= window) {
+            entry = lastWrite.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+    nextPrune = now + window;
+}
+
+bool RecentWriters::wroteRecently(std::string_view client) const {
+    if (client.empty() || window.count() == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    auto found = lastWrite.find(std::string(client));
+    return found != lastWrite.end() &&
+           Clock::now() - found->second < window;
+}
@@ -0,0 +1,50 @@
+#ifndef READROUTING_HPP
+#define READROUTING_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Where PostgresDB::withReadConnection() sent the reads
+struct ReadRoutingStats {
+    // Served by the read replica pool
+    std::uint64_t replicaReads = 0;
+    // Sent to the primary because the client wrote within the
+    // read-your-writes window
+    std::uint64_t primaryReads = 0;
+    // Retried on the primary after the replica failed
+    std::uint64_t fallbacks = 0;
+};
+
+/*
+ * Clients that wrote within the last window, so their next reads go to
+ * the primary and see their own writes despite replication lag. Clients
+ * are identified by whatever string the server passes (peer address or
+ * SERVER_CLIENT_HEADER); an empty one is never tracked. Expired entries
+ * are pruned at most once per window, on a write.
+ */
+class RecentWriters {
+   public:
+    explicit RecentWriters(std::chrono::milliseconds window_param)
+        : window(window_param) {}
+
+    void noteWrite(std::string_view client);
+
+    bool wroteRecently(std::string_view client) const;
+
+    std::chrono::milliseconds getWindow() const { return window; }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::milliseconds window;
+    mutable std::mutex mtx;
+    // Client -> time of its last write
+    std::unordered_map<std::string, Clock::time_point> lastWrite;
+    Clock::time_point nextPrune;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "ReservationExport.hpp"
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+struct ResultDeleter {
+    void operator()(PGresult* result) const { PQclear(result); }
+};
+using Result = std::unique_ptr<PGresult, ResultDeleter>;
+
+// Appends a line of COPY text format to out without its escapes. Only the
+// backslash sequences COPY itself writes are undone: the JSON escapes
+// inside the line (\" and the like) come out as \\" and are restored.
+void appendUnescaped(std::string& out, const char* line, int length) {
+    for (int i = 0; i < length; i++) {
+        char c = line[i];
+        if (c != '\\' || i + 1 == length) {
+            out += c;
+            continue;
+        }
+        switch (line[++i]) {
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'v':
+                out += '\v';
+                break;
+            default:
+                out += line[i];
+                break;
+        }
+    }
+}
+
+}  // namespace
+
+ReservationExport::ReservationExport(ConnectionPool::Lease conn_param,
+                                     const std::string& copySql,
+                                     ExportFormat format_param)
+    : conn(std::move(conn_param)), raw(nullptr), format(format_param) {
+    if (!conn->is_open()) {
+        throw std::runtime_error("Connection lost");
+    }
+    raw = std::move(*conn).release_raw_connection();
+    Result started(PQexec(raw, copySql.c_str()));
+    if (PQresultStatus(started.get()) != PGRES_COPY_OUT) {
+        std::string error = PQresultErrorMessage(started.get());
+        *conn = pqxx::connection::seize_raw_connection(raw);
+        throw std::runtime_error("Cannot start export: " + error);
+    }
+}
+
+ReservationExport::~ReservationExport() {
+    if (!finished) {
+        // Stop the server sending rows nobody reads, then skip those
+        // already on their way: the connection is usable again after that
+        if (PGcancel* cancel = PQgetCancel(raw)) {
+            char error[256];
+            PQcancel(cancel, error, sizeof(error));
+            PQfreeCancel(cancel);
+        }
+        char* line = nullptr;
+        while (PQgetCopyData(raw, &line, 0) > 0) {
+            PQfreemem(line);
+        }
+        while (Result result = Result(PQgetResult(raw))) {
+        }
+    }
+    bool clean = PQstatus(raw) == CONNECTION_OK &&
+                 PQtransactionStatus(raw) == PQTRANS_IDLE;
+    *conn = pqxx::connection::seize_raw_connection(raw);
+    if (!clean) {
+        std::cerr << "[ReservationExport] Connection left mid-export, "
+                     "closing it"
+                  << std::endl;
+        conn->close();
+    }
+}
+
+bool ReservationExport::read(std::string& out, std::size_t chunkBytes) {
+    out.clear();
+    while (!finished && out.size() < chunkBytes) {
+        char* line = nullptr;
+        // Blocks until a whole line arrived; -1 once the COPY is over
+        int length = PQgetCopyData(raw, &line, 0);
+        if (length > 0) {
+            if (format == ExportFormat::Ndjson) {
+                appendUnescaped(out, line, length);
+            } else {
+                out.append(line, static_cast<std::size_t>(length));
+            }
+            PQfreemem(line);
+        } else if (length == -1) {
+            finish();
+        } else {
+            fail("Cannot read export");
+        }
+    }
+    return !finished;
+}
+
+void ReservationExport::finish() {
+    Result result(PQgetResult(raw));
+    bool succeeded =
+        result && PQresultStatus(result.get()) == PGRES_COMMAND_OK;
+    std::string error = result ? PQresultErrorMessage(result.get()) : "";
+    while (Result rest = Result(PQgetResult(raw))) {
+    }
+    finished = true;
+    if (!succeeded) {
+        throw std::runtime_error("Export failed: " + error);
+    }
+}
+
+void ReservationExport::fail(const std::string& what) const {
+    throw std::runtime_error(what + ": " + PQerrorMessage(raw));
+}
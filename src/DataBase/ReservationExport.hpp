@@ -0,0 +1,75 @@
+#ifndef RESERVATIONEXPORT_HPP
+#define RESERVATIONEXPORT_HPP
+
+#include <libpq-fe.h>
+
+#include <cstddef>
+#include <string>
+
+#include "../Utils/ConnectionPool.hpp"
+
+// Output formats of a ReservationExport
+enum class ExportFormat {
+    // Header line, then one line per reservation
+    Csv,
+    // One JSON object per line
+    Ndjson
+};
+
+/*
+ * ReservationExport.hpp
+ *
+ * Output of a COPY ... TO STDOUT, read piece by piece. The server sends the
+ * rows as one data stream while they are read; nothing but the piece being
+ * read is held in memory, whatever the number of rows.
+ *
+ * Built by PostgresDB::exportReservations(). Like PipelinedConnection, it
+ * takes the raw libpq handle out of the leased connection while it lives
+ * (libpqxx only reads COPY output row by row, as typed values) and puts it
+ * back when destroyed. The lease is held until then.
+ */
+class ReservationExport {
+   public:
+    /**
+     * Start the COPY on conn
+     *
+     * param: conn - leased connection, owned by this object
+     * param: copySql - COPY (SELECT ...) TO STDOUT statement; in text
+     *        format its lines are NDJSON, in CSV format CSV
+     * throws: std::runtime_error if the statement fails
+     */
+    ReservationExport(ConnectionPool::Lease conn, const std::string& copySql,
+                      ExportFormat format);
+
+    /**
+     * Give the handle back to the connection. An export not read to the
+     * end is cancelled first; a connection left in an unknown state is
+     * closed instead, so the pool reconnects it on its next lease.
+     */
+    ~ReservationExport();
+
+    ReservationExport(const ReservationExport&) = delete;
+    ReservationExport& operator=(const ReservationExport&) = delete;
+
+    /**
+     * Replace out with the next lines, blocking until at least chunkBytes
+     * arrived or the export ended
+     *
+     * return: false once the export ended (out holds its last lines)
+     * throws: std::runtime_error if the server reports an error or the
+     *         connection fails; the export then cannot go on
+     */
+    bool read(std::string& out, std::size_t chunkBytes);
+
+   private:
+    ConnectionPool::Lease conn;
+    PGconn* raw;
+    ExportFormat format;
+    bool finished = false;
+
+    // Reads the result ending the COPY
+    void finish();
+    [[noreturn]] void fail(const std::string& what) const;
+};
+
+#endif
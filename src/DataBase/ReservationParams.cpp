@@ -0,0 +1,70 @@
+#include "ReservationParams.hpp"
+
+#include <pqxx/pqxx>
+#include <string_view>
+
+std::vector<std::string> insertParams(const Reservation& res) {
+    return {res.guest_name,
+            res.guest_email,
+            res.guest_phone,
+            pqxx::to_string(res.room_number),
+            res.room_type,
+            pqxx::to_string(res.number_of_guests),
+            res.check_in_date,
+            res.check_out_date,
+            pqxx::to_string(res.number_of_nights),
+            pqxx::to_string(res.price_per_night),
+            pqxx::to_string(res.total_price),
+            res.payment_method,
+            pqxx::to_string(res.paid),
+            res.reservation_status,
+            res.special_requests,
+            pqxx::to_string(res.created_at),
+            pqxx::to_string(res.updated_at)};
+}
+
+std::vector<std::string> updateParams(int id, const Reservation& res) {
+    return {res.guest_name,
+            res.guest_email,
+            res.guest_phone,
+            pqxx::to_string(res.room_number),
+            res.room_type,
+            pqxx::to_string(res.number_of_guests),
+            res.check_in_date,
+            res.check_out_date,
+            pqxx::to_string(res.number_of_nights),
+            pqxx::to_string(res.price_per_night),
+            pqxx::to_string(res.total_price),
+            res.payment_method,
+            pqxx::to_string(res.paid),
+            res.reservation_status,
+            res.special_requests,
+            pqxx::to_string(res.updated_at),
+            pqxx::to_string(id)};
+}
+
+Reservation reservationFromResult(const PGresult* result) {
+    auto text = [result](int column) {
+        return std::string_view(PQgetvalue(result, 0, column),
+                                PQgetlength(result, 0, column));
+    };
+    Reservation res;
+    res.guest_name = text(0);
+    res.guest_email = text(1);
+    res.guest_phone = text(2);
+    res.room_number = pqxx::from_string<int>(text(3));
+    res.room_type = text(4);
+    res.number_of_guests = pqxx::from_string<int>(text(5));
+    res.check_in_date = text(6);
+    res.check_out_date = text(7);
+    res.number_of_nights = pqxx::from_string<int>(text(8));
+    res.price_per_night = pqxx::from_string<double>(text(9));
+    res.total_price = pqxx::from_string<double>(text(10));
+    res.payment_method = text(11);
+    res.paid = pqxx::from_string<bool>(text(12));
+    res.reservation_status = text(13);
+    res.special_requests = text(14);
+    res.created_at = pqxx::from_string<long>(text(15));
+    res.updated_at = pqxx::from_string<long>(text(16));
+    return res;
+}
@@ -0,0 +1,29 @@
+#ifndef RESERVATIONPARAMS_HPP
+#define RESERVATIONPARAMS_HPP
+
+#include <libpq-fe.h>
+
+#include <string>
+#include <vector>
+
+#include "../HTTP/JsonHandler.hpp"
+
+/*
+ * ReservationParams.hpp
+ *
+ * Conversions for the prepared reservation statements when they are run
+ * through libpq directly (PipelinedConnection, AsyncConnection) instead of
+ * pqxx: parameters and results in libpq's text format.
+ */
+
+// Parameters $1..$17 of PostgresDB::kInsertReservation, in column order
+std::vector<std::string> insertParams(const Reservation& res);
+
+// Parameters $1..$17 of PostgresDB::kUpdateReservation
+std::vector<std::string> updateParams(int id, const Reservation& res);
+
+// First row of a PostgresDB::kGetReservation result, columns as read by
+// PostgresDB::getReservationById()
+Reservation reservationFromResult(const PGresult* result);
+
+#endif
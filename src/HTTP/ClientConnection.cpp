@@ -1,153 +1,60 @@
 #include "ClientConnection.hpp"
 
+#include <boost/beast/http.hpp>
 #include <iostream>
-#include <memory>
+#include <string>
 
-clientConnection::clientConnection(tcp::socket socket, PostgresDB* database)
-    : db(database), clientSocket(std::move(socket)) {}
+#include "HttpSession.hpp"
 
-void clientConnection::execute() {
-    try {
-        http::read(clientSocket, socketBuffer, httpRequest);
-        http::response<http::string_body> httpResponse;
-        processRequest(httpResponse);
-
-        httpResponse.version(httpRequest.version());
-        httpResponse.prepare_payload();
-        http::write(clientSocket, httpResponse);
-        clientSocket.shutdown(tcp::socket::shutdown_send);
-    } catch (const std::exception& e) {
-        std::cerr << "client execute error\n";
-        http::response<http::string_body> httpResponse;
-        http::write(clientSocket, httpResponse);
-        clientSocket.shutdown(tcp::socket::shutdown_send);
-    }
-}
-
-void clientConnection::processRequest(
-    http::response<http::string_body>& httpResponse) {
-    try {
-        std::string method = httpRequest.method_string();
-        std::string target = httpRequest.target();
-
-        if (method == "POST" && target.find("/application/reservation") == 0) {
-            handlePostHTTP(httpResponse);
-        } else if (method == "GET" &&
-                   target.find("/application/reservation/") == 0) {
-            handleGetHTTP(httpResponse);
-        } else if (method == "PUT" &&
-                   target.find("/application/reservation/") == 0) {
-            handlePutHTTP(httpResponse);
-        } else if (method == "DELETE" &&
-                   target.find("/application/reservation/") == 0) {
-            handleDeleteHTTP(httpResponse);
-        } else {
-            std::cerr << "client processRequest() error\n";
-            httpResponse.result(http::status::not_found);
-            httpResponse.body() = "Endpoint not found";
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "client processRequest() error\n";
-        httpResponse.result(http::status::bad_request);
-        httpResponse.body() = std::string("Error: ") + e.what();
-    }
-}
-
-void clientConnection::handlePostHTTP(
-    http::response<http::string_body>& httpResponse) {
-    try {
-        std::cerr
-            << "[ClientConnection] POST /reservations - parsing JSON...\n";
-        Reservation reservation = jsonHandler.parseJson(httpRequest.body());
-        std::cerr << "[ClientConnection] JSON parsed successfully for guest: "
-                  << reservation.guest_name << "\n";
-
-        std::cerr << "[ClientConnection] Acquiring connection from pool...\n";
-        auto conn = db->getConnectionPool()->acquire();
-        std::cerr
-            << "[ClientConnection] Connection acquired, inserting into DB...\n";
+clientConnection::clientConnection(tcp::socket socket,
+                                   RequestHandler& handler,
+                                   const ServerOptions& options_param,
+                                   ServerMetrics* serverMetrics)
+    : requestHandler(handler),
+      options(options_param),
+      metrics(serverMetrics),
+      clientSocket(std::move(socket)) {}
 
-        int reservationId = db->insertReservation(*conn, reservation);
-        std::cerr << "[ClientConnection] insertReservation returned ID: "
-                  << reservationId << "\n";
-
-        if (reservationId != -1) {
-            httpResponse.result(http::status::ok);
-            httpResponse.body() =
-                "Reservation saved with ID: " + std::to_string(reservationId);
-            std::cerr
-                << "[ClientConnection] SUCCESS - Reservation saved with ID: "
-                << reservationId << "\n";
-        } else {
-            httpResponse.result(http::status::internal_server_error);
-            httpResponse.body() = "Failed to make the reservation";
-            std::cerr
-                << "[ClientConnection] ERROR - insertReservation returned -1\n";
-        }
-
-        db->getConnectionPool()->release(std::move(conn));
-    } catch (const std::exception& e) {
-        httpResponse.result(http::status::internal_server_error);
-        httpResponse.body() = std::string("Error: ") + e.what();
-        std::cerr << "[ClientConnection] EXCEPTION in handlePostHTTP: "
-                  << e.what() << "\n";
-    }
-}
-void clientConnection::handleGetHTTP(
-    http::response<http::string_body>& httpResponse) {
+void clientConnection::execute() {
     try {
-        size_t pos = httpRequest.target().find_last_of('/');
-        int id = std::stoi(std::string(httpRequest.target().substr(pos + 1)));
-
-        Reservation currentRes = db->getReservationById(id);
-        httpResponse.result(http::status::ok);
-        httpResponse.body() = jsonHandler.reservationToJson(currentRes);
-    } catch (const std::runtime_error&) {
-        httpResponse.result(http::status::not_found);
-        httpResponse.body() = "Reservation not found";
+        // The accepted socket belongs to the server io_context, which is not
+        // run in blocking accept mode. Move it onto a private io_context that
+        // this worker runs until the session ends, so reads can time out
+        // while the worker thread still serves one connection at a time.
+        asio::io_context ioContext{1};
+        auto protocol = clientSocket.local_endpoint().protocol();
+        tcp::socket socket(ioContext, protocol, clientSocket.release());
+
+        HttpSession session(beast::tcp_stream(std::move(socket)),
+                            requestHandler, options, nullptr, metrics);
+        asio::co_spawn(ioContext, session.run(), asio::detached);
+        ioContext.run();
     } catch (const std::exception& e) {
-        httpResponse.result(http::status::bad_request);
-        httpResponse.body() = std::string("Error: ") + e.what();
+        std::cerr << "client execute error: " << e.what() << "\n";
     }
 }
-void clientConnection::handlePutHTTP(
-    http::response<http::string_body>& httpResponse) {
-    auto conn = db->getConnectionPool()->acquire();
 
+void clientConnection::reject(int retryAfterSeconds) {
     try {
-        size_t pos = httpRequest.target().find_last_of('/');
-        int id = std::stoi(std::string(httpRequest.target().substr(pos + 1)));
-
-        Reservation updated = jsonHandler.parseJson(httpRequest.body());
-        if (db->updateReservation(id, updated)) {
-            httpResponse.result(http::status::ok);
-            httpResponse.body() = "Reservation updated";
-        } else {
-            httpResponse.result(http::status::not_found);
-            httpResponse.body() = "Reservation not found";
+        // Small enough to fit in the socket send buffer, so this write does
+        // not block the accepting thread on a slow client
+        HttpResponse unavailable{http::status::service_unavailable, 11};
+        unavailable.set(http::field::retry_after,
+                        std::to_string(retryAfterSeconds));
+        unavailable.keep_alive(false);
+        unavailable.body() = "Service Unavailable";
+        unavailable.prepare_payload();
+        http::write(clientSocket, unavailable);
+
+        beast::error_code ec;
+        clientSocket.shutdown(tcp::socket::shutdown_send, ec);
+        // Closing with unread request bytes would send a RST that can
+        // discard the 503 before the client reads it; drop what arrived
+        char discard[1024];
+        while (!ec && clientSocket.available(ec) > 0) {
+            clientSocket.read_some(asio::buffer(discard), ec);
         }
     } catch (const std::exception& e) {
-        httpResponse.result(http::status::bad_request);
-        httpResponse.body() = std::string("Error: ") + e.what();
+        std::cerr << "client reject error: " << e.what() << "\n";
     }
-
-    db->getConnectionPool()->release(std::move(conn));
 }
-void clientConnection::handleDeleteHTTP(
-    http::response<http::string_body>& httpResponse) {
-    try {
-        size_t pos = httpRequest.target().find_last_of('/');
-        int id = std::stoi(std::string(httpRequest.target().substr(pos + 1)));
-
-        if (db->deleteReservation(id)) {
-            httpResponse.result(http::status::ok);
-            httpResponse.body() = "Reservation deleted";
-        } else {
-            httpResponse.result(http::status::not_found);
-            httpResponse.body() = "Reservation not found";
-        }
-    } catch (const std::exception& e) {
-        httpResponse.result(http::status::bad_request);
-        httpResponse.body() = std::string("Error: ") + e.what();
-    }
-}
\ No newline at end of file
@@ -3,52 +3,49 @@
 
 // Internal utilitys, buffers and error management
 #include <boost/beast/core.hpp>
-// HTTP and WebSocket
-#include <boost/beast/http.hpp>
 // Network, sockets, I/O
 #include <boost/asio.hpp>
 
-#include "../DataBase/PostgresDB.hpp"
-#include "JsonHandler.hpp"
+#include "RequestHandler.hpp"
+#include "ServerMetrics.hpp"
+#include "ServerOptions.hpp"
 // Task interface
 #include "../Utils/TaskInterface.hpp"
 
 // alias
 namespace beast = boost::beast;
-namespace http = beast::http;
 namespace asio = boost::asio;
 using tcp = asio::ip::tcp;
 
-// Handles a single client HTTP request. Implements Task interface for
-// thread pool execution. Parses HTTP request, validates JSON reservation data,
-// and sends appropriate HTTP response.
+// Handles one client HTTP connection on a ThreadPool worker (ThreadPool
+// session engine). Implements Task interface for thread pool execution: the
+// worker runs an HttpSession for the socket and stays busy until the
+// connection closes. HTTP/1.1 keep-alive is honored: the connection serves
+// requests until the client asks to close, the idle timeout expires or the
+// per-connection request limit is reached. Header, body and write deadlines
+// keep a slow or silent client from holding the worker forever.
 class clientConnection : public Task {
    public:
-    explicit clientConnection(tcp::socket socket,
-                              PostgresDB* database = nullptr);
+    // requestHandler, options and metrics are owned by the server and
+    // outlive the task; metrics may be null
+    clientConnection(tcp::socket socket, RequestHandler& requestHandler,
+                     const ServerOptions& options,
+                     ServerMetrics* metrics = nullptr);
 
     // Implements Task interface. Called by worker thread.
-    // Reads HTTP request, parses and validates JSON, sends response.
+    // Reads HTTP requests, parses and validates JSON, sends responses.
     void execute() override;
 
+    // Load shedding: the task did not fit in the ThreadPool queue. Answers
+    // 503 Service Unavailable with Retry-After and closes the connection
+    // without reading the request. Called from the accepting thread.
+    void reject(int retryAfterSeconds);
+
    private:
-    JsonHandler jsonHandler;
-    PostgresDB* db;
+    RequestHandler& requestHandler;
+    const ServerOptions& options;
+    ServerMetrics* metrics;
     tcp::socket clientSocket;
-    beast::flat_buffer socketBuffer;
-    http::request<http::string_body> httpRequest;
-
-    // Parses HTTP request and call the corresponding function according to what
-    // the user want to do (GET, POST, PUT, DELETE)
-    void processRequest(http::response<http::string_body>& httpResponse);
-    // HTTP POST new reservation
-    void handlePostHTTP(http::response<http::string_body>& httpresponse);
-    // HTTP GET reservation
-    void handleGetHTTP(http::response<http::string_body>& httpresponse);
-    // HTTP PUT (update reservation)
-    void handlePutHTTP(http::response<http::string_body>& httpresponse);
-    // HTTP DELETE reservation
-    void handleDeleteHTTP(http::response<http::string_body>& httpresponse);
 };
 
-#endif
\ No newline at end of file
+#endif
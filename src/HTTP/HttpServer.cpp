@@ -1,19 +1,85 @@
 #include "HttpServer.hpp"
 
+#include <pthread.h>
+
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
 #include "ClientConnection.hpp"
+#include "HttpSession.hpp"
+
+namespace {
+
+// The cache is built in the member initializers, before the constructor
+// body validates the other options. Replica reads of a reservation are
+// not cached for as long as the replica may lag behind its last write.
+std::unique_ptr<ReservationCache> makeReservationCache(
+    const ServerOptions& options, const PostgresDB* db) {
+    options.validate();
+    if (options.cacheEntries == 0) {
+        return nullptr;
+    }
+    auto settle = db != nullptr && db->getReadPool() != nullptr
+                      ? db->replicaLagBound()
+                      : std::chrono::milliseconds(0);
+    return std::make_unique<ReservationCache>(
+        static_cast<std::size_t>(options.cacheEntries),
+        std::chrono::milliseconds(options.cacheTtlMs),
+        static_cast<std::size_t>(options.cacheShards), settle);
+}
 
-HttpServer::HttpServer(PostgresDB* db, int port_param)
-    : ipv4(true), port(port_param), database(db), acceptor(nullptr) {
+}  // namespace
+
+HttpServer::HttpServer(PostgresDB* db, int port_param,
+                       ServerOptions options_param)
+    : ipv4(true),
+      port(port_param),
+      options(options_param),
+      database(db),
+      reservationCache(makeReservationCache(options_param, db)),
+      requestHandler(db, &serverMetrics, reservationCache.get()),
+      acceptor(nullptr),
+      threadPool(options.workerThreads, options.queueCapacity) {
     // Validate port immediately in constructor
     if (port <= 0) {
         throw std::invalid_argument(
             "Invalid port number: " + std::to_string(port) +
             ". Port must be greater than 0");
     }
+    options.validate();
+    serverMetrics.queueDepth = [this]() { return threadPool.queuedTasks(); };
+    serverMetrics.queueCapacity = [this]() {
+        return threadPool.queueCapacity();
+    };
+    serverMetrics.shardAcceptCounts = [this]() { return shardAcceptCounts(); };
+    if (database != nullptr) {
+        serverMetrics.databasePool = [this]() {
+            return database->getConnectionPool()->stats();
+        };
+        if (database->getInsertBatcher() != nullptr) {
+            serverMetrics.insertBatches = [this]() {
+                return database->getInsertBatcher()->stats();
+            };
+        }
+        if (database->getReadPool() != nullptr) {
+            serverMetrics.readPool = [this]() {
+                return database->getReadPool()->stats();
+            };
+            serverMetrics.readRouting = [this]() {
+                return database->readRoutingStats();
+            };
+        }
+    }
+    if (reservationCache) {
+        serverMetrics.reservationCache = [this]() {
+            return reservationCache->stats();
+        };
+    }
     // TODO: Get port from config if available when port_param is 0
     // if (port == 0) port = config.getInt("HTTP_PORT", 8080);
 }
@@ -26,28 +92,37 @@ void HttpServer::start() {
     } catch (...) {
         throw std::runtime_error("Failed to start HTTP acceptor");
     }
-    acceptConnections();
+    if (options.acceptMode == AcceptMode::Sharded) {
+        runShards();
+    } else if (options.usesIoThreads()) {
+        runAsyncAccept();
+    } else {
+        acceptConnections();
+    }
 }
 
 void HttpServer::stop() { stopServer(); }
 
 void HttpServer::startAcceptor() {
     try {
-        // Create acceptor now (deferred from constructor)
-        acceptor = std::make_unique<tcp::acceptor>(ioc);
-
-        if (ipv4) {
-            acceptor->open(tcp::v4());
-            // Set reuse_address BEFORE bind to allow rapid port reuse
-            // acceptor->set_option(tcp::acceptor::reuse_address(true));
-            acceptor->bind(tcp::endpoint(tcp::v4(), port));
-        } else {
-            acceptor->open(tcp::v6());
-            // Set reuse_address BEFORE bind to allow rapid port reuse
-            // acceptor->set_option(tcp::acceptor::reuse_address(true));
-            acceptor->bind(tcp::endpoint(tcp::v6(), port));
+        if (options.acceptMode == AcceptMode::Sharded) {
+            std::lock_guard<std::mutex> lock(serverMutex);
+            // stop() before start() found no shard to stop: open none
+            if (shouldStop) {
+                return;
+            }
+            for (int i = 0; i < options.shardCount(); i++) {
+                auto shard = std::make_unique<Shard>();
+                shard->acceptor = openAcceptor(shard->ioc, true);
+                shards.push_back(std::move(shard));
+            }
+            std::cout << "Server listening on port " << port << " with "
+                      << shards.size() << " SO_REUSEPORT shards\n";
+            return;
         }
-        acceptor->listen(asio::socket_base::max_listen_connections);
+
+        // Create acceptor now (deferred from constructor)
+        acceptor = openAcceptor(ioc, false);
 
         std::cout << "Server listening on port " << port << "\n";
     } catch (const std::exception& e) {
@@ -56,6 +131,28 @@ void HttpServer::startAcceptor() {
     }
 }
 
+std::unique_ptr<tcp::acceptor> HttpServer::openAcceptor(
+    asio::io_context& context, bool reusePort) {
+    auto listener = std::make_unique<tcp::acceptor>(context);
+    tcp protocol = ipv4 ? tcp::v4() : tcp::v6();
+
+    listener->open(protocol);
+    // Set reuse_address BEFORE bind to allow rapid port reuse
+    // listener->set_option(tcp::acceptor::reuse_address(true));
+    if (reusePort) {
+#ifdef SO_REUSEPORT
+        // Every shard binds the same port; the kernel load-balances new
+        // connections between the listening sockets
+        listener->set_option(ReusePort(true));
+#else
+        throw std::runtime_error("SO_REUSEPORT is not supported here");
+#endif
+    }
+    listener->bind(tcp::endpoint(protocol, port));
+    listener->listen(asio::socket_base::max_listen_connections);
+    return listener;
+}
+
 void HttpServer::acceptConnections() {
     while (!this->shouldStop) {
         try {
@@ -69,12 +166,7 @@ void HttpServer::acceptConnections() {
             tcp::socket currentSocket{ioc};
             acceptor->accept(currentSocket);
 
-            // we create the clientconnection with his respective socket and
-            // database
-            clientConnection client(std::move(currentSocket), database);
-            // now we put the task clientConnection in the queue to be consumed
-            // by a thread
-            threadPool.enqueueTask(std::move(client));
+            dispatchConnection(std::move(currentSocket));
 
         } catch (const std::exception& e) {
             if (!shouldStop) {
@@ -88,12 +180,177 @@ void HttpServer::acceptConnections() {
     ioc.run();
 }
 
+void HttpServer::runAsyncAccept() {
+    doAsyncAccept(*acceptor, ioc, nullptr);
+
+    std::vector<std::thread> ioThreads;
+    ioThreads.reserve(options.ioThreads - 1);
+    for (int i = 1; i < options.ioThreads; i++) {
+        ioThreads.emplace_back([this]() { ioc.run(); });
+    }
+    ioc.run();
+    for (auto& thread : ioThreads) {
+        thread.join();
+    }
+
+    // Every io thread has returned, so nothing else touches the acceptor now
+    try {
+        if (acceptor && acceptor->is_open()) {
+            acceptor->close();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "HttpServer::runAsyncAccept(): error closing acceptor: "
+                  << e.what() << "\n";
+    }
+}
+
+void HttpServer::runShards() {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> shardThreads;
+    {
+        // A stop() from here on finds the shards and stops their
+        // io_contexts, which makes run() return even if called after it
+        std::lock_guard<std::mutex> lock(serverMutex);
+        if (shouldStop) {
+            return;
+        }
+    }
+    shardThreads.reserve(shards.size());
+    for (size_t i = 0; i < shards.size(); i++) {
+        Shard& shard = *shards[i];
+        doAsyncAccept(*shard.acceptor, shard.ioc, &shard.accepted);
+        shardThreads.emplace_back([&shard]() { shard.ioc.run(); });
+        pinToCore(shardThreads.back(), i % cores);
+    }
+    for (auto& thread : shardThreads) {
+        thread.join();
+    }
+
+    // Every shard thread has returned, so the acceptors are ours again
+    for (auto& shard : shards) {
+        try {
+            if (shard->acceptor->is_open()) {
+                shard->acceptor->close();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "HttpServer::runShards(): error closing acceptor: "
+                      << e.what() << "\n";
+        }
+    }
+}
+
+void HttpServer::pinToCore(std::thread& thread, unsigned core) {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    int rc = pthread_setaffinity_np(thread.native_handle(), sizeof(cpus),
+                                    &cpus);
+    if (rc != 0) {
+        std::cerr << "HttpServer::pinToCore(): could not pin shard to core "
+                  << core << ", error " << rc << "\n";
+    }
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+std::vector<std::uint64_t> HttpServer::shardAcceptCounts() const {
+    std::lock_guard<std::mutex> lock(serverMutex);
+    std::vector<std::uint64_t> counts;
+    counts.reserve(shards.size());
+    for (const auto& shard : shards) {
+        counts.push_back(shard->accepted.load());
+    }
+    return counts;
+}
+
+void HttpServer::doAsyncAccept(tcp::acceptor& listener,
+                               asio::io_context& context,
+                               std::atomic<std::uint64_t>* accepted) {
+    // Only one accept is outstanding per listener, so an acceptor is never
+    // used concurrently even with several io threads. Each socket gets its
+    // own strand, which serializes its coroutine and tcp_stream timer.
+    listener.async_accept(
+        asio::make_strand(context),
+        [this, &listener, &context, accepted](
+            const boost::system::error_code& ec, tcp::socket socket) {
+            if (shouldStop || ec == asio::error::operation_aborted) {
+                return;
+            }
+            if (ec) {
+                std::cerr << "HttpServer::doAsyncAccept(): error accepting "
+                             "connection: "
+                          << ec.message() << "\n";
+            } else {
+                if (accepted != nullptr) {
+                    accepted->fetch_add(1, std::memory_order_relaxed);
+                }
+                dispatchConnection(std::move(socket));
+            }
+            doAsyncAccept(listener, context, accepted);
+        });
+}
+
+const ServerMetrics& HttpServer::metrics() const { return serverMetrics; }
+
+void HttpServer::dispatchConnection(tcp::socket socket) {
+    serverMetrics.acceptedConnections.fetch_add(1, std::memory_order_relaxed);
+    if (options.sessionEngine == SessionEngine::Coroutine) {
+        startSession(std::move(socket));
+        return;
+    }
+    // we create the clientconnection with his respective socket and the
+    // shared request handler, then put it in the queue to be consumed by a
+    // thread unless too many connections are already waiting
+    auto client = std::make_unique<clientConnection>(
+        std::move(socket), requestHandler, options, &serverMetrics);
+    if (!threadPool.tryEnqueueTask(client)) {
+        serverMetrics.rejectedConnections.fetch_add(1,
+                                                    std::memory_order_relaxed);
+        client->reject(options.retryAfterSeconds);
+    }
+}
+
+void HttpServer::startSession(tcp::socket socket) {
+    auto executor = socket.get_executor();
+    auto session = std::make_unique<HttpSession>(
+        beast::tcp_stream(std::move(socket)), requestHandler, options,
+        &threadPool, &serverMetrics);
+    // co_spawn keeps the lambda, and with it the session, alive until the
+    // coroutine finishes
+    asio::co_spawn(
+        executor,
+        [session = std::move(session)]() -> asio::awaitable<void> {
+            co_await session->run();
+        },
+        asio::detached);
+}
+
 void HttpServer::stopServer() {
     {
         std::unique_lock<std::mutex> lock(this->serverMutex);
         this->shouldStop = true;
     }
     this->cond_var.notify_all();
+    if (options.acceptMode == AcceptMode::Sharded) {
+        // Same as below, per shard: runShards() closes the acceptors once
+        // the shard threads have returned
+        std::lock_guard<std::mutex> lock(this->serverMutex);
+        for (auto& shard : shards) {
+            shard->ioc.stop();
+        }
+        std::cerr << "Server shutting down gracefull..\n";
+        return;
+    }
+    if (options.usesIoThreads()) {
+        // The acceptor belongs to the io threads; stopping the io_context makes
+        // runAsyncAccept() return and close it from the start() thread.
+        ioc.stop();
+        std::cerr << "Server shutting down gracefull..\n";
+        return;
+    }
     try {
         if (acceptor && acceptor->is_open()) {
             acceptor->close();
@@ -16,12 +16,17 @@
 // Network, sockets, I/O
 #include <boost/asio.hpp>
 // for concurrency
+#include <cstdint>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "../DataBase/PostgresDB.hpp"
 #include "../Utils/ThreadPool.hpp"
 #include "../config/ConfigManager.hpp"
+#include "RequestHandler.hpp"
+#include "ServerMetrics.hpp"
+#include "ServerOptions.hpp"
 
 // shutdown (thread-safe) librarys
 #include <atomic>
@@ -33,43 +38,98 @@
 namespace asio = boost::asio;
 using tcp = asio::ip::tcp;
 
+#ifdef SO_REUSEPORT
+using ReusePort =
+    asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
 // HTTP server with thread pool for concurrent request handling.
 // Accepts connections on a specified port and delegates request processing
-// to worker threads. Graceful shutdown is triggered by signals (SIGINT,
-// SIGTERM, SIGTSTP) or through destructor cleanup.
+// to worker threads. Connections are accepted either by a blocking loop or by
+// an async_accept chain running on a configurable number of io threads, and
+// served either by a ThreadPool worker each or by coroutines on the io
+// threads (see ServerOptions). With a bounded ThreadPool queue, work that
+// does not fit is shed with 503 Service Unavailable. Graceful shutdown is
+// triggered by signals (SIGINT, SIGTERM, SIGTSTP) or through destructor
+// cleanup.
 class HttpServer {
    public:
     // Constructor: initializes server with database connection
     // port: 0 = use default (8080), or specify custom port for testing
-    HttpServer(PostgresDB* db, int port = 8080);
+    // options: accept mode and thread counts, defaults to blocking accept
+    HttpServer(PostgresDB* db, int port = 8080,
+               ServerOptions options = ServerOptions{});
     // Destructor: triggers graceful shutdown sequence
     ~HttpServer();
     // Starts the server: opens acceptor and accepts connections (blocking)
     void start();
     // Stops the server gracefully
     void stop();
-    // Opens TCP acceptor on configured port. Throws runtime_error if someting
-    // went wrong
+    // Opens TCP acceptor on configured port (one per shard in Sharded mode).
+    // Throws runtime_error if someting went wrong
     void startAcceptor();
+    // Sharded mode: connections accepted so far by each listener shard, to
+    // check that the kernel balances them. Empty in other modes.
+    std::vector<std::uint64_t> shardAcceptCounts() const;
+    // Admission and load shedding counters, also served on GET /metrics
+    const ServerMetrics& metrics() const;
 
    private:
     bool ipv4;
     int port;
+    ServerOptions options;
     PostgresDB* database;
+    ServerMetrics serverMetrics;
+    // GET by ID cache, nullptr unless options.cacheEntries > 0. Declared
+    // before requestHandler, which uses it.
+    std::unique_ptr<ReservationCache> reservationCache;
+    // Shared by every connection; answers parsed requests
+    RequestHandler requestHandler;
     // ASIO context managing all I/O operations
     asio::io_context ioc;
     // TCP acceptor listening for incoming connections
     std::unique_ptr<tcp::acceptor> acceptor;
+    // SO_REUSEPORT listener shard: its own acceptor, single-threaded
+    // io_context and thread, plus a counter to check load balance
+    struct Shard {
+        asio::io_context ioc{1};
+        std::unique_ptr<tcp::acceptor> acceptor;
+        std::atomic<std::uint64_t> accepted{0};
+    };
+    // Only used in Sharded mode, where ioc and acceptor above stay idle
+    std::vector<std::unique_ptr<Shard>> shards;
     // Thread-safe flag: set to true by signal handler or stop sequence
     std::atomic<bool> shouldStop{false};
-    std::mutex serverMutex;
+    mutable std::mutex serverMutex;
     std::condition_variable cond_var;
-    // Worker thread pool (4 threads) for processing client requests
-    ThreadPool threadPool{4};
+    // Worker thread pool (options.workerThreads threads, at most
+    // options.queueCapacity queued tasks) for processing client requests.
+    // Declared last so it is destroyed first: pending tasks still see the
+    // handler, options and io_context they reference.
+    ThreadPool threadPool;
 
     // Accepts incoming connections and enqueues them for processing.
     // Runs in calling thread of start(). Detects shutdown via shouldStop flag.
     void acceptConnections();
+    // Opens, binds and listens a TCP acceptor on the configured port
+    std::unique_ptr<tcp::acceptor> openAcceptor(asio::io_context& context,
+                                                bool reusePort);
+    // Async mode: arms the async_accept chain and runs the io_context on
+    // options.ioThreads threads (the caller is one of them) until stop().
+    void runAsyncAccept();
+    // Sharded mode: runs every shard on its own pinned thread until stop()
+    void runShards();
+    // Best effort: failing to pin only costs locality, so it just logs
+    static void pinToCore(std::thread& thread, unsigned core);
+    // Hands an accepted socket to the session engine. ThreadPool engine:
+    // answers 503 right away when the pool queue is full.
+    void dispatchConnection(tcp::socket socket);
+    // Posts one async_accept on listener; its handler counts the connection
+    // (when accepted is not null), dispatches the socket and re-arms.
+    void doAsyncAccept(tcp::acceptor& listener, asio::io_context& context,
+                       std::atomic<std::uint64_t>* accepted);
+    // Coroutine engine: spawns an HttpSession for the socket on its strand
+    void startSession(tcp::socket socket);
     // Initiates graceful shutdown: closes acceptor, stops IO context,
     // and signals worker threads to complete their tasks.
     void stopServer();
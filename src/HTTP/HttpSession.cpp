@@ -0,0 +1,312 @@
+#include "HttpSession.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../Utils/TaskInterface.hpp"
+
+namespace {
+
+// ThreadPool task running work for a suspended session. Completion handler
+// gets the work's exception (if any) and whether it ran, and is always
+// invoked on the session's executor, never on the worker thread.
+template <typename Handler>
+class OffloadedCall : public Task {
+   public:
+    OffloadedCall(std::function<void()> work, Handler handler)
+        : work(std::move(work)),
+          handler(std::move(handler)),
+          // Keeps the io_context from running out of work while the pool
+          // holds the only reference to the session's continuation
+          guard(asio::make_work_guard(
+              asio::get_associated_executor(this->handler))) {}
+
+    void execute() override {
+        std::exception_ptr error;
+        try {
+            work();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        complete(error, true);
+    }
+
+    // The pool refused the task: resume the session without running work
+    void reject() { complete(nullptr, false); }
+
+   private:
+    std::function<void()> work;
+    Handler handler;
+    asio::executor_work_guard<asio::associated_executor_t<Handler>> guard;
+
+    void complete(std::exception_ptr error, bool admitted) {
+        asio::post(guard.get_executor(),
+                   [handler = std::move(handler), error, admitted]() mutable {
+                       std::move(handler)(error, admitted);
+                   });
+    }
+};
+
+// Errors that mean the peer sent something that is not valid HTTP, as
+// opposed to closing the connection or timing out
+bool isMalformedRequest(const beast::error_code& ec) {
+    return ec.category() ==
+               http::make_error_code(http::error::end_of_stream).category() &&
+           ec != http::error::end_of_stream &&
+           ec != http::error::partial_message;
+}
+
+// Who sent request, for read-your-writes routing: the value of header when
+// one is configured and the request carries it, else the peer address
+std::string_view clientOf(const HttpRequest& request,
+                          const std::string& header,
+                          const std::string& peerAddress) {
+    if (!header.empty()) {
+        auto found = request.find(header);
+        if (found != request.end() && !found->value().empty()) {
+            return std::string_view(found->value().data(),
+                                    found->value().size());
+        }
+    }
+    return peerAddress;
+}
+
+}  // namespace
+
+HttpSession::HttpSession(beast::tcp_stream stream_param,
+                         RequestHandler& handler,
+                         const ServerOptions& options_param,
+                         ThreadPool* pool, ServerMetrics* serverMetrics)
+    : stream(std::move(stream_param)),
+      requestHandler(handler),
+      options(options_param),
+      blockingPool(pool),
+      metrics(serverMetrics) {
+    beast::error_code ec;
+    auto peer = stream.socket().remote_endpoint(ec);
+    if (!ec) {
+        clientAddress = peer.address().to_string();
+    }
+}
+
+asio::awaitable<void> HttpSession::run() {
+    try {
+        co_await serveRequests();
+    } catch (const std::exception& e) {
+        std::cerr << "HttpSession::run() error: " << e.what() << "\n";
+    }
+    beast::error_code ec;
+    stream.socket().shutdown(tcp::socket::shutdown_send, ec);
+}
+
+asio::awaitable<void> HttpSession::serveRequests() {
+    // A Beast parser handles exactly one message; emplace() re-creates it in
+    // the same storage for each request instead of allocating a new one
+    std::optional<http::request_parser<RequestBody>> requestParser;
+    for (int served = 0; served < options.maxRequestsPerConnection;
+         served++) {
+        // The previous request and its JSON document are gone by now
+        jsonContext.reset();
+        requestParser.emplace();
+        requestParser->get().body().useContext(&jsonContext);
+        // Beast checks Content-Length against the limit while parsing the
+        // headers, before the route is known: start with the larger one
+        requestParser->body_limit(static_cast<std::uint64_t>(
+            std::max(options.maxBodyBytes, options.maxBulkBodyBytes)));
+        // The wait for the next request on a kept-alive connection is
+        // bounded by the idle timeout, the first request by the header one
+        int headerTimeoutMs = served == 0 ? options.headerTimeoutMs
+                                          : options.keepAliveTimeoutMs;
+        stream.expires_after(std::chrono::milliseconds(headerTimeoutMs));
+        beast::error_code ec;
+        co_await http::async_read_header(
+            stream, socketBuffer, *requestParser,
+            asio::redirect_error(asio::use_awaitable, ec));
+        if (!ec && !requestParser->is_done()) {
+            auto target = requestParser->get().target();
+            auto limit = static_cast<std::uint64_t>(
+                RequestHandler::isBulkTarget(
+                    std::string_view(target.data(), target.size()))
+                    ? options.maxBulkBodyBytes
+                    : options.maxBodyBytes);
+            auto length = requestParser->content_length();
+            if (length && *length > limit) {
+                ec = http::error::body_limit;
+            } else {
+                // Enforced on chunked bodies as they arrive
+                requestParser->body_limit(limit);
+            }
+        }
+        if (!ec && !requestParser->is_done()) {
+            stream.expires_after(
+                std::chrono::milliseconds(options.bodyTimeoutMs));
+            co_await http::async_read(
+                stream, socketBuffer, *requestParser,
+                asio::redirect_error(asio::use_awaitable, ec));
+        }
+        if (ec) {
+            if (ec == http::error::body_limit) {
+                HttpResponse tooLarge{http::status::payload_too_large, 11};
+                tooLarge.keep_alive(false);
+                tooLarge.body() = "Request body too large";
+                tooLarge.prepare_payload();
+                co_await writeResponse(tooLarge);
+            } else if (isMalformedRequest(ec)) {
+                HttpResponse badRequest{http::status::bad_request, 11};
+                badRequest.keep_alive(false);
+                badRequest.body() = "Malformed HTTP request";
+                badRequest.prepare_payload();
+                co_await writeResponse(badRequest);
+            } else if (ec == beast::error::timeout) {
+                // Nothing at all received after a response is just the end
+                // of keep-alive; anything else is a slow or silent client
+                bool idle = served > 0 && socketBuffer.size() == 0 &&
+                            !requestParser->got_some();
+                if (!idle) {
+                    countTimeout();
+                }
+            }
+            // end_of_stream (client closed) and timeouts close silently
+            co_return;
+        }
+        HttpRequest httpRequest = requestParser->release();
+
+        HttpResponse httpResponse;
+        responseBuffer.clear();
+        httpResponse.body().swap(responseBuffer);
+        std::unique_ptr<ResponseStream> streamedBody;
+        bool admitted = co_await runBlocking(
+            [this, &httpRequest, &httpResponse, &streamedBody]() {
+                streamedBody = requestHandler.handle(
+                    httpRequest, httpResponse,
+                    clientOf(httpRequest, options.clientHeader,
+                             clientAddress));
+            });
+        if (!admitted) {
+            // Shed load: close so the client retries elsewhere or later
+            if (metrics != nullptr) {
+                metrics->rejectedRequests.fetch_add(
+                    1, std::memory_order_relaxed);
+            }
+            httpResponse.result(http::status::service_unavailable);
+            httpResponse.set(http::field::retry_after,
+                             std::to_string(options.retryAfterSeconds));
+            httpResponse.body() = "Service Unavailable";
+        }
+
+        bool keepAlive = admitted && httpRequest.keep_alive() &&
+                         served + 1 < options.maxRequestsPerConnection;
+        httpResponse.version(httpRequest.version());
+        httpResponse.keep_alive(keepAlive);
+
+        bool written = false;
+        if (streamedBody) {
+            written = co_await writeStreamed(httpResponse,
+                                             std::move(streamedBody));
+        } else {
+            httpResponse.prepare_payload();
+            written = co_await writeResponse(httpResponse);
+        }
+        responseBuffer.swap(httpResponse.body());
+        if (!written || !keepAlive) {
+            co_return;
+        }
+    }
+}
+
+asio::awaitable<bool> HttpSession::writeResponse(HttpResponse& response) {
+    stream.expires_after(std::chrono::milliseconds(options.writeTimeoutMs));
+    beast::error_code ec;
+    co_await http::async_write(stream, response,
+                               asio::redirect_error(asio::use_awaitable, ec));
+    if (ec == beast::error::timeout) {
+        countTimeout();
+    }
+    co_return !ec;
+}
+
+asio::awaitable<bool> HttpSession::writeStreamed(
+    HttpResponse& response, std::unique_ptr<ResponseStream> body) {
+    http::response<http::empty_body> header{std::move(response.base())};
+    header.chunked(true);
+    http::response_serializer<http::empty_body> serializer{header};
+    stream.expires_after(std::chrono::milliseconds(options.writeTimeoutMs));
+    beast::error_code ec;
+    co_await http::async_write_header(
+        stream, serializer, asio::redirect_error(asio::use_awaitable, ec));
+
+    // One piece in memory at a time: the next one is only read once this
+    // one is written, so a slow client slows the producer down
+    std::string piece;
+    bool more = true;
+    while (!ec && more) {
+        bool produced = false;
+        try {
+            produced = co_await runBlocking(
+                [&body, &piece, &more]() { more = body->next(piece); });
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpSession] Streamed response failed: "
+                      << e.what() << std::endl;
+        }
+        if (!produced) {
+            // No terminating chunk: the client sees a truncated body
+            ec = asio::error::operation_aborted;
+            break;
+        }
+        if (!piece.empty()) {
+            stream.expires_after(
+                std::chrono::milliseconds(options.writeTimeoutMs));
+            co_await asio::async_write(
+                stream, http::make_chunk(asio::buffer(piece)),
+                asio::redirect_error(asio::use_awaitable, ec));
+        }
+    }
+    if (!ec) {
+        stream.expires_after(std::chrono::milliseconds(options.writeTimeoutMs));
+        co_await asio::async_write(
+            stream, http::make_chunk_last(),
+            asio::redirect_error(asio::use_awaitable, ec));
+    }
+    if (ec == beast::error::timeout) {
+        countTimeout();
+    }
+    // Abandoning an unfinished body (e.g. cancelling its query) can block
+    if (!co_await runBlocking([&body]() { body.reset(); })) {
+        body.reset();
+    }
+    co_return !ec;
+}
+
+void HttpSession::countTimeout() {
+    if (metrics != nullptr) {
+        metrics->timedOutConnections.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+asio::awaitable<bool> HttpSession::runBlocking(std::function<void()> work) {
+    if (blockingPool == nullptr) {
+        work();
+        co_return true;
+    }
+
+    auto initiate = [this](auto handler, std::function<void()> work) {
+        auto call = std::make_unique<OffloadedCall<decltype(handler)>>(
+            std::move(work), std::move(handler));
+        if (!blockingPool->tryEnqueueTask(call)) {
+            call->reject();
+        }
+    };
+    // use_awaitable rethrows a non-null exception_ptr and yields the bool
+    co_return co_await asio::async_initiate<decltype(asio::use_awaitable),
+                                            void(std::exception_ptr, bool)>(
+        initiate, asio::use_awaitable, std::move(work));
+}
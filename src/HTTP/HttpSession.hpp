@@ -0,0 +1,87 @@
+#ifndef HTTPSESSION_HPP
+#define HTTPSESSION_HPP
+
+// Internal utilitys, buffers and error management
+#include <boost/beast/core.hpp>
+// HTTP and WebSocket
+#include <boost/beast/http.hpp>
+// Network, sockets, I/O and coroutines
+#include <boost/asio.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "../Utils/ThreadPool.hpp"
+#include "RequestBody.hpp"
+#include "RequestHandler.hpp"
+#include "ServerMetrics.hpp"
+#include "ServerOptions.hpp"
+
+// alias
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+// One HTTP/1.1 connection written as a coroutine: read a request, let the
+// RequestHandler answer it, write the response and repeat while keep-alive
+// allows. Both session engines run this same code:
+// - ThreadPool engine: clientConnection drives it on a private io_context
+//   from a worker thread, and the handler runs inline on that worker.
+// - Coroutine engine: it runs on the server io threads, and only the handler
+//   (the blocking database work) is handed to the ThreadPool, so idle
+//   connections cost memory but no thread. When the pool queue is full the
+//   request is answered 503 with Retry-After instead of waiting.
+class HttpSession {
+   public:
+    // blockingPool: where handler work runs; nullptr runs it inline
+    // metrics: counts shed requests and expired deadlines when not null
+    HttpSession(beast::tcp_stream stream, RequestHandler& requestHandler,
+                const ServerOptions& options,
+                ThreadPool* blockingPool = nullptr,
+                ServerMetrics* metrics = nullptr);
+
+    // Serves requests until the connection has to be closed, then closes it.
+    // The session object must outlive the returned awaitable.
+    asio::awaitable<void> run();
+
+   private:
+    beast::tcp_stream stream;
+    RequestHandler& requestHandler;
+    const ServerOptions& options;
+    ThreadPool* blockingPool;
+    ServerMetrics* metrics;
+    // Reused across every request of the connection. Pipelined requests that
+    // arrived together stay in this buffer and are parsed on the next turn,
+    // so they are answered in order.
+    beast::flat_buffer socketBuffer;
+    // JSON request bodies are parsed into this arena, released between
+    // requests
+    JsonParseContext jsonContext;
+    // Response body storage handed from one response to the next, so the
+    // handler writes into memory the connection already owns
+    std::string responseBuffer;
+    // Peer IP address, empty if unknown: identifies the client to the
+    // read routing of PostgresDB (its writes are read back from the primary)
+    // unless options.clientHeader names it
+    std::string clientAddress;
+
+    // Keep-alive loop; returns when the connection must be closed. Headers,
+    // body and response each get their own deadline from options.
+    asio::awaitable<void> serveRequests();
+    // Writes response within options.writeTimeoutMs; false on any error
+    asio::awaitable<bool> writeResponse(HttpResponse& response);
+    // Writes the header of response, then body piece by piece with chunked
+    // encoding, each write within options.writeTimeoutMs. Producing a piece
+    // is blocking work, run like the handler. False on any error, or when
+    // the pool refuses a piece: the body is then incomplete.
+    asio::awaitable<bool> writeStreamed(HttpResponse& response,
+                                        std::unique_ptr<ResponseStream> body);
+    void countTimeout();
+    // Runs work on blockingPool and resumes on this session's executor once
+    // it finished, rethrowing its exception if any. Inline without a pool.
+    // Returns false, without running work, when the pool queue is full.
+    asio::awaitable<bool> runBlocking(std::function<void()> work);
+};
+
+#endif
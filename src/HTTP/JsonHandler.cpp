@@ -1,57 +1,212 @@
 #include "JsonHandler.hpp"
 
+#include <array>
+#include <charconv>
+#include <cmath>
 #include <iostream>
 
+namespace {
+
+// Helpers for reservationToJson(res, out). They reproduce what
+// boost::json::serialize writes, byte for byte.
+
+// JSON string with Boost.JSON escaping: quote, backslash and the short
+// control escapes, \u00XX (lowercase hex) for other control characters,
+// everything else (UTF-8 included) copied as is
+void appendString(std::string& out, std::string_view key,
+                  std::string_view value) {
+    static constexpr char hex[] = "0123456789abcdef";
+    out.append(key);
+    out.push_back('"');
+    std::size_t plain = 0;
+    for (std::size_t i = 0; i < value.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(value.substr(plain, i - plain));
+        plain = i + 1;
+        switch (c) {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\b':
+                out.append("\\b");
+                break;
+            case '\f':
+                out.append("\\f");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default:
+                out.append("\\u00");
+                out.push_back(hex[c >> 4]);
+                out.push_back(hex[c & 0xf]);
+        }
+    }
+    out.append(value.substr(plain));
+    out.push_back('"');
+}
+
+void appendInteger(std::string& out, std::string_view key, long value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(key);
+    out.append(digits, result.ptr);
+}
+
+// Boost.JSON prints doubles as the shortest round-trip digits in Ryu's
+// scientific form (150.5 -> 1.505E2, 1 -> 1E0). std::to_chars yields the
+// same digits as "1.505e+02"; only the exponent is rewritten.
+void appendDouble(std::string& out, std::string_view key, double value) {
+    out.append(key);
+    if (std::isnan(value)) {
+        out.append("null");
+        return;
+    }
+    if (std::isinf(value)) {
+        out.append(value < 0 ? "-1e99999" : "1e99999");
+        return;
+    }
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value,
+                                std::chars_format::scientific);
+    std::string_view text(digits, result.ptr - digits);
+    std::size_t e = text.find('e');
+    out.append(text.substr(0, e));
+    out.push_back('E');
+    if (text[e + 1] == '-') {
+        out.push_back('-');
+    }
+    // Drop the sign and leading zeros of the exponent, keep one digit
+    std::string_view exponent = text.substr(e + 2);
+    while (exponent.size() > 1 && exponent.front() == '0') {
+        exponent.remove_prefix(1);
+    }
+    out.append(exponent);
+}
+
+// Fields parseJson() refuses to go without
+constexpr std::array<std::string_view, 15> kRequiredFields = {
+    "guest_name",
+    "guest_email",
+    "guest_phone",
+    "room_number",
+    "room_type",
+    "number_of_guests",
+    "check_in_date",
+    "check_out_date",
+    "number_of_nights",
+    "price_per_night",
+    "total_price",
+    "payment_method",
+    "paid",
+    "created_at",
+    "updated_at"};
+
+// Copies a string member into target, reusing target's capacity
+void assignString(std::string& target, const boost::json::object& json,
+                  std::string_view key) {
+    const boost::json::string& value = json.at(key).as_string();
+    target.assign(value.data(), value.size());
+}
+
+// The members of a reservation object, without the braces
+void appendFields(std::string& out, const Reservation& res) {
+    // Guest data
+    appendString(out, "\"guest_name\":", res.guest_name);
+    appendString(out, ",\"guest_email\":", res.guest_email);
+    appendString(out, ",\"guest_phone\":", res.guest_phone);
+
+    // Reservation info
+    appendInteger(out, ",\"room_number\":", res.room_number);
+    appendString(out, ",\"room_type\":", res.room_type);
+    appendInteger(out, ",\"number_of_guests\":", res.number_of_guests);
+
+    // Dates
+    appendString(out, ",\"check_in_date\":", res.check_in_date);
+    appendString(out, ",\"check_out_date\":", res.check_out_date);
+    appendInteger(out, ",\"number_of_nights\":", res.number_of_nights);
+
+    // Cost
+    appendDouble(out, ",\"price_per_night\":", res.price_per_night);
+    appendDouble(out, ",\"total_price\":", res.total_price);
+    appendString(out, ",\"payment_method\":", res.payment_method);
+    out.append(",\"paid\":");
+    out.append(res.paid ? "true" : "false");
+
+    // Status
+    appendString(out, ",\"reservation_status\":", res.reservation_status);
+    appendString(out, ",\"special_requests\":", res.special_requests);
+
+    // Metadata timestamps
+    appendInteger(out, ",\"created_at\":", res.created_at);
+    appendInteger(out, ",\"updated_at\":", res.updated_at);
+}
+
+}  // namespace
+
 Reservation JsonHandler::parseJson(const std::string& jsonFile) {
-    Reservation currentReservation;
+    boost::json::value json;
     try {
         // parsing json
-        boost::json::object currentJson =
-            boost::json::parse(jsonFile).as_object();
+        json = boost::json::parse(jsonFile);
+    } catch (const std::exception& e) {
+        throw std::invalid_argument("JSON parsing failed: " +
+                                    std::string(e.what()));
+    }
+    return parseJson(json);
+}
+
+Reservation JsonHandler::parseJson(const boost::json::value& json) {
+    Reservation currentReservation;
+    parseJson(json, currentReservation);
+    return currentReservation;
+}
+
+void JsonHandler::parseJson(const boost::json::value& json,
+                            Reservation& currentReservation) {
+    try {
+        const boost::json::object& currentJson = json.as_object();
 
         // Check required fields first
-        std::vector<std::string> requiredFields = {"guest_name",
-                                                   "guest_email",
-                                                   "guest_phone",
-                                                   "room_number",
-                                                   "room_type",
-                                                   "number_of_guests",
-                                                   "check_in_date",
-                                                   "check_out_date",
-                                                   "number_of_nights",
-                                                   "price_per_night",
-                                                   "total_price",
-                                                   "payment_method",
-                                                   "paid",
-                                                   "created_at",
-                                                   "updated_at"};
-
-        for (const auto& field : requiredFields) {
+        for (std::string_view field : kRequiredFields) {
             if (!currentJson.contains(field)) {
-                throw std::invalid_argument("Missing required field: " + field);
+                throw std::invalid_argument("Missing required field: " +
+                                            std::string(field));
             }
         }
 
         // Guest data
-        currentReservation.guest_name =
-            currentJson.at("guest_name").as_string();
-        currentReservation.guest_email =
-            currentJson.at("guest_email").as_string();
-        currentReservation.guest_phone =
-            currentJson.at("guest_phone").as_string();
+        assignString(currentReservation.guest_name, currentJson,
+                     "guest_name");
+        assignString(currentReservation.guest_email, currentJson,
+                     "guest_email");
+        assignString(currentReservation.guest_phone, currentJson,
+                     "guest_phone");
 
         // Reservation info
         currentReservation.room_number =
             currentJson.at("room_number").as_int64();
-        currentReservation.room_type = currentJson.at("room_type").as_string();
+        assignString(currentReservation.room_type, currentJson, "room_type");
         currentReservation.number_of_guests =
             currentJson.at("number_of_guests").as_int64();
 
         // Dates
-        currentReservation.check_in_date =
-            currentJson.at("check_in_date").as_string();
-        currentReservation.check_out_date =
-            currentJson.at("check_out_date").as_string();
+        assignString(currentReservation.check_in_date, currentJson,
+                     "check_in_date");
+        assignString(currentReservation.check_out_date, currentJson,
+                     "check_out_date");
         currentReservation.number_of_nights =
             currentJson.at("number_of_nights").as_int64();
 
@@ -60,20 +215,22 @@ Reservation JsonHandler::parseJson(const std::string& jsonFile) {
             currentJson.at("price_per_night").as_double();
         currentReservation.total_price =
             currentJson.at("total_price").as_double();
-        currentReservation.payment_method =
-            currentJson.at("payment_method").as_string();
+        assignString(currentReservation.payment_method, currentJson,
+                     "payment_method");
         currentReservation.paid = currentJson.at("paid").as_bool();
 
         // Status (opcional, tiene valor por defecto)
+        currentReservation.reservation_status.clear();
         if (currentJson.contains("reservation_status")) {
-            currentReservation.reservation_status =
-                currentJson.at("reservation_status").as_string();
+            assignString(currentReservation.reservation_status, currentJson,
+                         "reservation_status");
         }
 
         // Special requests (opcional)
+        currentReservation.special_requests.clear();
         if (currentJson.contains("special_requests")) {
-            currentReservation.special_requests =
-                currentJson.at("special_requests").as_string();
+            assignString(currentReservation.special_requests, currentJson,
+                         "special_requests");
         }
 
         // Metadata timestamps
@@ -89,49 +246,63 @@ Reservation JsonHandler::parseJson(const std::string& jsonFile) {
         throw std::invalid_argument("JSON parsing failed: " +
                                     std::string(e.what()));
     }
-
-    return currentReservation;
-};
+}
 
 std::string JsonHandler::reservationToJson(const Reservation& res) {
-    try {
-        boost::json::object jsonObj;
-
-        // Guest data
-        jsonObj["guest_name"] = res.guest_name;
-        jsonObj["guest_email"] = res.guest_email;
-        jsonObj["guest_phone"] = res.guest_phone;
+    std::string json;
+    reservationToJson(res, json);
+    return json;
+}
 
-        // Reservation info
-        jsonObj["room_number"] = res.room_number;
-        jsonObj["room_type"] = res.room_type;
-        jsonObj["number_of_guests"] = res.number_of_guests;
+void JsonHandler::reservationToJson(const Reservation& res,
+                                    std::string& out) {
+    out.clear();
+    // Keys and punctuation take 300 bytes and the numbers at most ~170,
+    // plus the strings
+    out.reserve(512 + res.guest_name.size() + res.guest_email.size() +
+                res.guest_phone.size() + res.room_type.size() +
+                res.payment_method.size() + res.reservation_status.size() +
+                res.special_requests.size());
 
-        // Dates
-        jsonObj["check_in_date"] = res.check_in_date;
-        jsonObj["check_out_date"] = res.check_out_date;
-        jsonObj["number_of_nights"] = res.number_of_nights;
+    // Same keys, order and formatting as serializing the boost::json::object
+    // this used to build
+    out.push_back('{');
+    appendFields(out, res);
+    out.push_back('}');
+}
 
-        // Cost
-        jsonObj["price_per_night"] = res.price_per_night;
-        jsonObj["total_price"] = res.total_price;
-        jsonObj["payment_method"] = res.payment_method;
-        jsonObj["paid"] = res.paid;
+void JsonHandler::reservationsToJson(
+    const std::vector<StoredReservation>& items, std::string& out) {
+    beginReservationList(out);
+    for (const StoredReservation& item : items) {
+        appendReservationItem(item.id, item.reservation, out);
+    }
+    endReservationList(out);
+}
 
-        // Status
-        jsonObj["reservation_status"] = res.reservation_status;
-        jsonObj["special_requests"] = res.special_requests;
+void JsonHandler::beginReservationList(std::string& out) {
+    out.clear();
+    out.append("{\"items\":[");
+}
 
-        // Metadata timestamps
-        jsonObj["created_at"] = res.created_at;
-        jsonObj["updated_at"] = res.updated_at;
+void JsonHandler::appendReservationItem(int id, const Reservation& res,
+                                        std::string& out) {
+    if (out.back() != '[') {
+        out.push_back(',');
+    }
+    appendInteger(out, "{\"id\":", id);
+    out.push_back(',');
+    appendFields(out, res);
+    out.push_back('}');
+}
 
-        // Convert to string
-        return boost::json::serialize(jsonObj);
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Failed to serialize reservation to JSON: " +
-                                 std::string(e.what()));
+void JsonHandler::endReservationList(std::string& out,
+                                     std::string_view nextCursor) {
+    out.push_back(']');
+    if (!nextCursor.empty()) {
+        appendString(out, ",\"next_cursor\":", nextCursor);
     }
+    out.push_back('}');
 }
 
 bool JsonHandler::validateJsonFormat(const Reservation& reservation) {
@@ -4,6 +4,8 @@
 #include <boost/json.hpp>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 // this struct represents all the reservation fundamental information
 struct Reservation {
@@ -32,17 +34,45 @@ struct Reservation {
     long updated_at;
 };
 
+// A stored reservation with the ID the database assigned, as listed by
+// searches
+struct StoredReservation {
+    int id;
+    Reservation reservation;
+};
+
 // this class receives the json and then, parse it
 class JsonHandler {
    public:
     JsonHandler() = default;
     // parse the json and returns a Reservation object
     Reservation parseJson(const std::string& jsonFile);
+    // same, from a document already parsed (e.g. streamed from the socket)
+    Reservation parseJson(const boost::json::value& json);
+    // same, into an existing Reservation whose strings keep their capacity,
+    // so a reused scratch object parses without allocating
+    void parseJson(const boost::json::value& json, Reservation& reservation);
     // this function validates that the current json have all the reservation
     // information, if thats not the case, returns false
     bool validateJsonFormat(const Reservation& reservation);
     // translates a Reservation object to JSON string for HTTP response
     std::string reservationToJson(const Reservation& res);
+    // same bytes as above, written straight into out (its previous content
+    // is replaced, its capacity reused): no DOM and, once out has grown to
+    // the usual size, no allocation
+    void reservationToJson(const Reservation& res, std::string& out);
+    // {"items":[...]}, each item the reservation object above with its
+    // "id" first; written into out like reservationToJson
+    void reservationsToJson(const std::vector<StoredReservation>& items,
+                            std::string& out);
+    // The same list written one item at a time, for rows streamed from the
+    // database: begin (replaces the content of out), one append per row,
+    // then end. A non-empty nextCursor is added as "next_cursor".
+    void beginReservationList(std::string& out);
+    void appendReservationItem(int id, const Reservation& res,
+                               std::string& out);
+    void endReservationList(std::string& out,
+                            std::string_view nextCursor = {});
 
    private:
 };
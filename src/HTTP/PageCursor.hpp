@@ -0,0 +1,94 @@
+#ifndef PAGECURSOR_HPP
+#define PAGECURSOR_HPP
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../DataBase/PostgresDB.hpp"
+
+// Opaque cursors of GET /application/reservations: the sort order and the
+// key of the last row of a page, base64url encoded. Clients hand them back
+// as they got them; the order is part of the cursor, so one cannot be
+// replayed with another order.
+class PageCursor {
+   public:
+    static std::string encode(ReservationOrder order,
+                              const ReservationKey& key) {
+        std::string plain = order == ReservationOrder::CheckInDate
+                                ? "d." + key.checkInDate + "."
+                                : std::string("i.");
+        plain += std::to_string(key.id);
+
+        std::string out;
+        unsigned bits = 0;
+        int pending = 0;
+        for (unsigned char c : plain) {
+            bits = (bits << 8) | c;
+            pending += 8;
+            while (pending >= 6) {
+                pending -= 6;
+                out.push_back(kAlphabet[(bits >> pending) & 0x3f]);
+            }
+        }
+        if (pending > 0) {
+            out.push_back(kAlphabet[(bits << (6 - pending)) & 0x3f]);
+        }
+        return out;
+    }
+
+    // throws: std::invalid_argument if cursor was not made by encode() for
+    //         the same order
+    static ReservationKey decode(std::string_view cursor,
+                                 ReservationOrder order) {
+        std::string plain;
+        unsigned bits = 0;
+        int pending = 0;
+        for (char c : cursor) {
+            auto value = kAlphabet.find(c);
+            if (value == std::string_view::npos) {
+                invalid();
+            }
+            bits = (bits << 6) | static_cast<unsigned>(value);
+            pending += 6;
+            if (pending >= 8) {
+                pending -= 8;
+                plain.push_back(static_cast<char>((bits >> pending) & 0xff));
+            }
+        }
+
+        std::string_view text = plain;
+        ReservationKey key;
+        if (order == ReservationOrder::CheckInDate) {
+            // "d.YYYY-MM-DD.<id>"
+            if (text.size() < 14 || text.substr(0, 2) != "d." ||
+                text[12] != '.') {
+                invalid();
+            }
+            key.checkInDate = std::string(text.substr(2, 10));
+            text.remove_prefix(13);
+        } else {
+            if (text.substr(0, 2) != "i.") {
+                invalid();
+            }
+            text.remove_prefix(2);
+        }
+        auto [end, ec] =
+            std::from_chars(text.data(), text.data() + text.size(), key.id);
+        if (ec != std::errc() || end != text.data() + text.size()) {
+            invalid();
+        }
+        return key;
+    }
+
+   private:
+    static constexpr std::string_view kAlphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    [[noreturn]] static void invalid() {
+        throw std::invalid_argument("Invalid cursor for this order");
+    }
+};
+
+#endif
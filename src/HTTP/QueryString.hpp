@@ -0,0 +1,93 @@
+#ifndef QUERYSTRING_HPP
+#define QUERYSTRING_HPP
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Parameters of a request target's query string, "/path?a=1&b=x%20y".
+// Names and values are percent-decoded, with '+' read as a space. A name
+// without '=' has an empty value; when a name repeats, the first one wins.
+class QueryString {
+   public:
+    // throws: std::invalid_argument on a malformed percent escape
+    explicit QueryString(std::string_view target) {
+        std::size_t question = target.find('?');
+        if (question == std::string_view::npos) {
+            return;
+        }
+        std::string_view query = target.substr(question + 1);
+        while (!query.empty()) {
+            std::size_t amp = query.find('&');
+            std::string_view pair = query.substr(0, amp);
+            query = amp == std::string_view::npos ? std::string_view()
+                                                  : query.substr(amp + 1);
+            if (pair.empty()) {
+                continue;
+            }
+            std::size_t equals = pair.find('=');
+            std::string_view value = equals == std::string_view::npos
+                                         ? std::string_view()
+                                         : pair.substr(equals + 1);
+            params.emplace_back(decode(pair.substr(0, equals)),
+                                decode(value));
+        }
+    }
+
+    std::optional<std::string> get(std::string_view name) const {
+        for (const auto& [paramName, value] : params) {
+            if (paramName == name) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Every parameter, in target order
+    const std::vector<std::pair<std::string, std::string>>& all() const {
+        return params;
+    }
+
+   private:
+    std::vector<std::pair<std::string, std::string>> params;
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    static std::string decode(std::string_view text) {
+        std::string out;
+        out.reserve(text.size());
+        for (std::size_t i = 0; i < text.size(); i++) {
+            if (text[i] == '+') {
+                out.push_back(' ');
+            } else if (text[i] != '%') {
+                out.push_back(text[i]);
+            } else {
+                int high = i + 2 < text.size() ? hexValue(text[i + 1]) : -1;
+                int low = high >= 0 ? hexValue(text[i + 2]) : -1;
+                if (low < 0) {
+                    throw std::invalid_argument(
+                        "Malformed percent escape in query string");
+                }
+                out.push_back(static_cast<char>(high * 16 + low));
+                i += 2;
+            }
+        }
+        return out;
+    }
+};
+
+#endif
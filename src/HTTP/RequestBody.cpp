@@ -0,0 +1,85 @@
+#include "RequestBody.hpp"
+
+#include <algorithm>
+
+JsonParseContext::JsonParseContext(std::size_t initialSize_param)
+    : initialSize(initialSize_param) {}
+
+void JsonParseContext::reset() {
+    if (arena) {
+        arena->release();
+        streamParser.reset(&*arena);
+    }
+}
+
+boost::json::stream_parser& JsonParseContext::parser() {
+    if (!arena) {
+        initialBuffer = std::make_unique_for_overwrite<unsigned char[]>(
+            initialSize);
+        arena.emplace(initialBuffer.get(), initialSize);
+        streamParser.reset(&*arena);
+    }
+    return streamParser;
+}
+
+bool RequestBody::isJsonContentType(std::string_view contentType) {
+    std::string_view mediaType = contentType.substr(0, contentType.find(';'));
+    while (!mediaType.empty() && mediaType.back() == ' ') {
+        mediaType.remove_suffix(1);
+    }
+    return beast::iequals(
+        beast::string_view(mediaType.data(), mediaType.size()),
+        "application/json");
+}
+
+const boost::json::value& RequestBody::value_type::json() const {
+    static const boost::json::value null;
+    return document ? *document : null;
+}
+
+void RequestBody::reader::init(
+    const boost::optional<std::uint64_t>& contentLength,
+    beast::error_code& ec) {
+    ec = {};
+    body.document.reset();
+    body.error = {};
+    body.raw.clear();
+    body.received = 0;
+    if (body.jsonBody && body.jsonContext != nullptr) {
+        body.parser = &body.jsonContext->parser();
+    } else if (body.jsonBody) {
+        body.ownParser = std::make_unique<boost::json::stream_parser>();
+        body.parser = body.ownParser.get();
+    } else if (contentLength) {
+        // Same cap as string_body: never trust the peer for a huge reserve
+        body.raw.reserve(static_cast<std::size_t>(
+            std::min<std::uint64_t>(*contentLength, 1024 * 1024)));
+    }
+}
+
+void RequestBody::reader::append(const char* data, std::size_t size) {
+    body.received += size;
+    if (!body.jsonBody) {
+        body.raw.append(data, size);
+        return;
+    }
+    // After a syntax error the rest of the body is read and dropped
+    if (!body.error) {
+        body.parser->write(data, size, body.error);
+    }
+}
+
+void RequestBody::reader::finish(beast::error_code& ec) {
+    ec = {};
+    if (!body.jsonBody) {
+        return;
+    }
+    if (!body.error) {
+        body.parser->finish(body.error);
+    }
+    if (!body.error) {
+        body.document.emplace(body.parser->release());
+    }
+    body.parser = nullptr;
+    body.ownParser.reset();
+}
@@ -0,0 +1,131 @@
+#ifndef REQUESTBODY_HPP
+#define REQUESTBODY_HPP
+
+// Internal utilitys, buffers and error management
+#include <boost/beast/core.hpp>
+// HTTP messages
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// alias
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+// Per-session JSON parsing state, reused by every request of a connection:
+// a stream_parser and a monotonic arena the request documents are built in.
+// After the first requests neither needs the global heap, so parsing does
+// not contend on malloc with the other workers. The arena is only allocated
+// by the first JSON body, so idle connections do not pay for it.
+class JsonParseContext {
+   public:
+    // initialSize: arena bytes available before falling back to the heap
+    explicit JsonParseContext(std::size_t initialSize = 16 * 1024);
+
+    // Frees every document parsed since the previous reset() at once and
+    // rearms the parser. No document from the previous request may still
+    // be alive.
+    void reset();
+
+    // Ready to parse a document into the arena
+    boost::json::stream_parser& parser();
+
+   private:
+    std::size_t initialSize;
+    std::unique_ptr<unsigned char[]> initialBuffer;
+    std::optional<boost::json::monotonic_resource> arena;
+    boost::json::stream_parser streamParser;
+};
+
+// Beast body type for incoming requests. A request whose Content-Type is
+// application/json is fed to a boost::json::stream_parser chunk by chunk
+// while it is read from the socket, so parsing overlaps the network read
+// and the raw text is never stored next to the DOM. Any other body is kept
+// as text, like http::string_body.
+//
+// A JSON syntax error does not fail the HTTP read: it is recorded in the
+// body, so the handler can still answer 400 on a well-formed connection.
+// With useContext() the document lives in the session's arena and must not
+// outlive the request.
+struct RequestBody {
+    class reader;
+
+    class value_type {
+       public:
+        // True when the request declared a JSON body, which then lives in
+        // json() and not in text()
+        bool isJson() const { return jsonBody; }
+        // Parsed document; null for non-JSON bodies and on errors
+        const boost::json::value& json() const;
+        // Why a JSON body could not be parsed (empty body included)
+        const boost::json::error_code& jsonError() const { return error; }
+        // Body of non-JSON requests
+        const std::string& text() const { return raw; }
+        // Body bytes received, whatever the content type
+        std::uint64_t size() const { return received; }
+        // Parse with context's parser and arena instead of a parser of our
+        // own on the heap. Call before the body is read.
+        void useContext(JsonParseContext* context) { jsonContext = context; }
+
+       private:
+        friend class RequestBody::reader;
+
+        bool jsonBody = false;
+        // optional, because assigning a value built in another storage
+        // (the arena) deep-copies it; emplace() moves it in instead
+        std::optional<boost::json::value> document;
+        boost::json::error_code error;
+        std::string raw;
+        std::uint64_t received = 0;
+        JsonParseContext* jsonContext = nullptr;
+        // Only set while the body is being read: jsonContext's parser, or
+        // ownParser without a context
+        boost::json::stream_parser* parser = nullptr;
+        std::unique_ptr<boost::json::stream_parser> ownParser;
+    };
+
+    // True for "application/json", parameters such as charset ignored
+    static bool isJsonContentType(std::string_view contentType);
+
+    // Beast BodyReader: constructed once the headers are parsed
+    class reader {
+       public:
+        template <bool isRequest, class Fields>
+        reader(http::header<isRequest, Fields>& header, value_type& body)
+            : body(body) {
+            auto contentType = header[http::field::content_type];
+            body.jsonBody = isJsonContentType(
+                std::string_view(contentType.data(), contentType.size()));
+        }
+
+        void init(const boost::optional<std::uint64_t>& contentLength,
+                  beast::error_code& ec);
+
+        template <class ConstBufferSequence>
+        std::size_t put(const ConstBufferSequence& buffers,
+                        beast::error_code& ec) {
+            ec = {};
+            std::size_t consumed = 0;
+            for (auto buffer : beast::buffers_range_ref(buffers)) {
+                append(static_cast<const char*>(buffer.data()),
+                       buffer.size());
+                consumed += buffer.size();
+            }
+            return consumed;
+        }
+
+        void finish(beast::error_code& ec);
+
+       private:
+        value_type& body;
+
+        void append(const char* data, std::size_t size);
+    };
+};
+
+#endif
@@ -0,0 +1,671 @@
+#include "RequestHandler.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../DataBase/BulkLoader.hpp"
+#include "PageCursor.hpp"
+#include "QueryString.hpp"
+
+// Adding an endpoint: one line here, kRouteCount in the header
+constexpr Router<RequestHandler::Endpoint, RequestHandler::kRouteCount>
+    RequestHandler::router{{{
+        {http::verb::post, "/application/reservation",
+         &RequestHandler::handlePostHTTP},
+        {http::verb::post, RequestHandler::kBulkPath,
+         &RequestHandler::handleBatchPostHTTP},
+        {http::verb::get, "/application/reservation/{id:int}",
+         &RequestHandler::handleGetHTTP},
+        {http::verb::put, "/application/reservation/{id:int}",
+         &RequestHandler::handlePutHTTP},
+        {http::verb::delete_, "/application/reservation/{id:int}",
+         &RequestHandler::handleDeleteHTTP},
+        {http::verb::get, "/application/reservations",
+         &RequestHandler::handleSearchHTTP},
+        {http::verb::get, "/application/reservations/export",
+         &RequestHandler::handleExportHTTP},
+        {http::verb::get, "/application/rooms/{room:int}/availability",
+         &RequestHandler::handleAvailabilityHTTP},
+        {http::verb::get, "/metrics", &RequestHandler::handleMetricsHTTP},
+    }}};
+
+namespace {
+
+// Client of the request handle() is running on this thread. Handlers run
+// synchronously inside handle(), so they read it instead of every endpoint
+// taking one more parameter.
+thread_local std::string_view currentClient;
+// Streamed body an endpoint set for handle() to return
+thread_local std::unique_ptr<ResponseStream> streamedBody;
+
+// Export rows per piece of a streamed body: enough to keep the socket
+// busy, little enough that a slow client holds no real memory
+constexpr std::size_t kExportChunkBytes = 64 * 1024;
+
+// Body of an export, read from its COPY as the client takes it
+class ExportBody : public ResponseStream {
+   public:
+    explicit ExportBody(std::unique_ptr<ReservationExport> source_param)
+        : source(std::move(source_param)) {}
+
+    bool next(std::string& out) override {
+        return source->read(out, kExportChunkBytes);
+    }
+
+   private:
+    std::unique_ptr<ReservationExport> source;
+};
+
+// No database connection could be leased, or the one leased was lost:
+// the request may succeed later
+void databaseUnavailable(HttpResponse& httpResponse,
+                         const std::exception& e) {
+    httpResponse.result(http::status::service_unavailable);
+    httpResponse.set(http::field::retry_after, "1");
+    httpResponse.body() = std::string("Database unavailable: ") + e.what();
+    std::cerr << "[RequestHandler] " << e.what() << "\n";
+}
+
+// Summary of a bulk request: rows loaded, their IDs as [first, last]
+// ranges in row order, and the rows rejected, each as
+// {"line": n, "error": "..."}, by line
+void bulkResult(HttpResponse& httpResponse, const BulkLoader& loader,
+                std::vector<BulkLoader::Rejected>& errors) {
+    std::stable_sort(errors.begin(), errors.end(),
+                     [](const BulkLoader::Rejected& a,
+                        const BulkLoader::Rejected& b) {
+                         return a.line < b.line;
+                     });
+    boost::json::array ids;
+    for (const BulkLoader::IdRange& range : loader.ids()) {
+        boost::json::array pair;
+        pair.push_back(range.first);
+        pair.push_back(range.last);
+        ids.push_back(std::move(pair));
+    }
+    boost::json::array rejected;
+    for (const BulkLoader::Rejected& error : errors) {
+        boost::json::object entry;
+        entry["line"] = error.line;
+        entry["error"] = error.error;
+        rejected.push_back(std::move(entry));
+    }
+    boost::json::object result;
+    result["inserted"] = loader.inserted();
+    result["ids"] = std::move(ids);
+    result["errors"] = std::move(rejected);
+    httpResponse.set(http::field::content_type, "application/json");
+    httpResponse.body() = boost::json::serialize(result);
+}
+
+// Calls visit(line, text) for each non-blank line of an NDJSON body,
+// lines counted from 1
+template <typename Visit>
+void forEachNdjsonLine(std::string_view text, Visit&& visit) {
+    std::size_t line = 0;
+    while (!text.empty()) {
+        std::size_t newline = text.find('\n');
+        std::string_view current = text.substr(0, newline);
+        text = newline == std::string_view::npos ? std::string_view()
+                                                 : text.substr(newline + 1);
+        line++;
+        if (current.find_first_not_of(" \t\r") != std::string_view::npos) {
+            visit(line, current);
+        }
+    }
+}
+
+// Positive integer query parameter
+int positiveParam(const std::string& name, const std::string& value) {
+    int number = 0;
+    auto [end, ec] =
+        std::from_chars(value.data(), value.data() + value.size(), number);
+    if (ec != std::errc() || end != value.data() + value.size() ||
+        number <= 0) {
+        throw std::invalid_argument(name + " must be a positive integer");
+    }
+    return number;
+}
+
+// Date query parameter, an existing YYYY-MM-DD day
+const std::string& dateParam(const std::string& name,
+                             const std::string& value) {
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    const char* text = value.data();
+    bool parsed = value.size() == 10 && value[4] == '-' && value[7] == '-' &&
+                  std::from_chars(text, text + 4, year).ptr == text + 4 &&
+                  std::from_chars(text + 5, text + 7, month).ptr == text + 7 &&
+                  std::from_chars(text + 8, text + 10, day).ptr == text + 10;
+    if (!parsed || !std::chrono::year_month_day(std::chrono::year(year),
+                                                std::chrono::month(month),
+                                                std::chrono::day(day))
+                        .ok()) {
+        throw std::invalid_argument(name + " must be a date (YYYY-MM-DD)");
+    }
+    return value;
+}
+
+// Filters of GET /application/reservations, or of an export (paged false:
+// no limit, order or cursor, and a format parameter read elsewhere)
+ReservationSearch parseSearch(std::string_view target, bool paged = true) {
+    ReservationSearch search;
+    std::optional<std::string> cursor;
+    for (const auto& [name, value] : QueryString(target).all()) {
+        bool paging =
+            name == "limit" || name == "order" || name == "cursor";
+        if (!paged && paging) {
+            throw std::invalid_argument(name + " does not apply to exports");
+        }
+        if (!paged && name == "format") {
+            continue;
+        }
+        if (name == "room_number") {
+            search.roomNumber = positiveParam(name, value);
+        } else if (name == "from") {
+            search.from = dateParam(name, value);
+        } else if (name == "to") {
+            search.to = dateParam(name, value);
+        } else if (name == "status") {
+            search.status = value;
+        } else if (name == "limit") {
+            search.limit = static_cast<std::size_t>(positiveParam(name, value));
+        } else if (name == "order" && value == "id") {
+            search.order = ReservationOrder::Id;
+        } else if (name == "order" && value == "check_in_date") {
+            search.order = ReservationOrder::CheckInDate;
+        } else if (name == "order") {
+            throw std::invalid_argument("order must be id or check_in_date");
+        } else if (name == "cursor") {
+            cursor = value;
+        } else {
+            throw std::invalid_argument("Unknown query parameter: " + name);
+        }
+    }
+    if (search.from && search.to && *search.from > *search.to) {
+        throw std::invalid_argument("from must not be after to");
+    }
+    if (search.limit > PostgresDB::kMaxSearchLimit) {
+        throw std::invalid_argument(
+            "limit must be at most " +
+            std::to_string(PostgresDB::kMaxSearchLimit));
+    }
+    if (cursor) {
+        search.after = PageCursor::decode(*cursor, search.order);
+        if (search.order == ReservationOrder::CheckInDate) {
+            dateParam("cursor", search.after->checkInDate);
+        }
+    }
+    return search;
+}
+
+std::string_view targetOf(const HttpRequest& httpRequest) {
+    auto target = httpRequest.target();
+    return std::string_view(target.data(), target.size());
+}
+
+}  // namespace
+
+bool RequestHandler::isBulkTarget(std::string_view target) {
+    return target.substr(0, target.find('?')) == kBulkPath;
+}
+
+RequestHandler::RequestHandler(PostgresDB* database,
+                               const ServerMetrics* serverMetrics,
+                               ReservationCache* reservationCache)
+    : db(database), metrics(serverMetrics), cache(reservationCache) {}
+
+std::unique_ptr<ResponseStream> RequestHandler::handle(
+    const HttpRequest& httpRequest, HttpResponse& httpResponse,
+    std::string_view clientAddress) {
+    currentClient = clientAddress;
+    streamedBody.reset();
+    try {
+        auto target = httpRequest.target();
+        auto route = router.match(
+            httpRequest.method(),
+            std::string_view(target.data(), target.size()));
+
+        switch (route.status) {
+            case RouteStatus::Matched:
+                (this->*route.handler)(route.params, httpRequest,
+                                       httpResponse);
+                break;
+            case RouteStatus::InvalidParameter:
+                httpResponse.result(http::status::bad_request);
+                httpResponse.body() = "Error: invalid path parameter";
+                break;
+            case RouteStatus::NotFound:
+                std::cerr << "RequestHandler::handle() error\n";
+                httpResponse.result(http::status::not_found);
+                httpResponse.body() = "Endpoint not found";
+                break;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "RequestHandler::handle() error\n";
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = std::string("Error: ") + e.what();
+    }
+    currentClient = {};
+    return std::move(streamedBody);
+}
+
+const Reservation& RequestHandler::parseReservation(
+    const HttpRequest& httpRequest) {
+    // One scratch Reservation per worker thread: its strings keep their
+    // capacity from one request to the next
+    thread_local Reservation scratch;
+    const auto& body = httpRequest.body();
+    if (!body.isJson()) {
+        // Clients that do not send Content-Type: application/json
+        scratch = jsonHandler.parseJson(body.text());
+    } else if (body.jsonError()) {
+        throw std::invalid_argument("JSON parsing failed: " +
+                                    body.jsonError().message());
+    } else {
+        jsonHandler.parseJson(body.json(), scratch);
+    }
+    db->checkStay(scratch);
+    return scratch;
+}
+
+void RequestHandler::handlePostHTTP(const PathParams&,
+                                    const HttpRequest& httpRequest,
+                                    HttpResponse& httpResponse) {
+    try {
+        std::cerr
+            << "[RequestHandler] POST /reservations - parsing JSON...\n";
+        const Reservation& reservation = parseReservation(httpRequest);
+        std::cerr << "[RequestHandler] JSON parsed successfully for guest: "
+                  << reservation.guest_name << "\n";
+
+        int reservationId = -1;
+        if (InsertBatcher* batcher = db->getInsertBatcher()) {
+            // Shares a commit with the other POSTs of the next few
+            // microseconds
+            reservationId = batcher->submit(reservation).get();
+        } else {
+            std::cerr
+                << "[RequestHandler] Acquiring connection from pool...\n";
+            auto conn = db->getConnectionPool()->acquire();
+            std::cerr << "[RequestHandler] Connection acquired, inserting "
+                         "into DB...\n";
+            reservationId = db->insertReservation(*conn, reservation);
+        }
+        std::cerr << "[RequestHandler] insertReservation returned ID: "
+                  << reservationId << "\n";
+
+        if (reservationId != -1) {
+            db->noteWrite(currentClient);
+            httpResponse.result(http::status::ok);
+            httpResponse.body() =
+                "Reservation saved with ID: " + std::to_string(reservationId);
+            std::cerr
+                << "[RequestHandler] SUCCESS - Reservation saved with ID: "
+                << reservationId << "\n";
+        } else {
+            httpResponse.result(http::status::internal_server_error);
+            httpResponse.body() = "Failed to make the reservation";
+            std::cerr
+                << "[RequestHandler] ERROR - insertReservation returned -1\n";
+        }
+    } catch (const StayOutsidePartitions& e) {
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = std::string("Error: ") + e.what();
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        httpResponse.result(http::status::internal_server_error);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        std::cerr << "[RequestHandler] EXCEPTION in handlePostHTTP: "
+                  << e.what() << "\n";
+    }
+}
+void RequestHandler::handleBatchPostHTTP(const PathParams&,
+                                         const HttpRequest& httpRequest,
+                                         HttpResponse& httpResponse) {
+    const auto& body = httpRequest.body();
+    const boost::json::array* items = nullptr;
+    if (body.isJson()) {
+        // A JSON array: "line" is the position of the element, from 1
+        if (body.jsonError()) {
+            httpResponse.result(http::status::bad_request);
+            httpResponse.body() = "Error: JSON parsing failed: " +
+                                  body.jsonError().message();
+            return;
+        }
+        if (!body.json().is_array()) {
+            httpResponse.result(http::status::bad_request);
+            httpResponse.body() = "Error: expected an array of reservations";
+            return;
+        }
+        items = &body.json().as_array();
+    }
+    std::size_t maxRows = 0;
+    if (items != nullptr) {
+        maxRows = items->size();
+    } else {
+        forEachNdjsonLine(body.text(),
+                          [&maxRows](std::size_t, std::string_view) {
+                              maxRows++;
+                          });
+    }
+    if (maxRows == 0) {
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = "Error: no reservations to load";
+        return;
+    }
+
+    std::vector<BulkLoader::Rejected> errors;
+    auto reject = [&errors](std::size_t line, std::string_view message) {
+        errors.push_back({line, std::string(message)});
+    };
+    try {
+        // Rows go to the database as they are parsed, a chunk at a time
+        auto conn = db->getConnectionPool()->acquire();
+        BulkLoader loader(*conn, maxRows);
+        Reservation row;
+        auto loadRow = [&](std::size_t line, const boost::json::value& json) {
+            try {
+                // parseJson() also runs validateJsonFormat()
+                jsonHandler.parseJson(json, row);
+                db->checkStay(row);
+            } catch (const std::exception& e) {
+                reject(line, e.what());
+                return;
+            }
+            loader.add(line, row);
+        };
+
+        if (items != nullptr) {
+            std::size_t position = 0;
+            for (const boost::json::value& item : *items) {
+                loadRow(++position, item);
+            }
+        } else {
+            // NDJSON: one reservation per line, blank lines ignored. Each
+            // line is parsed into the same small arena, released before
+            // the next.
+            unsigned char buffer[4096];
+            boost::json::monotonic_resource lineArena(buffer, sizeof(buffer));
+            forEachNdjsonLine(
+                body.text(), [&](std::size_t line, std::string_view text) {
+                    lineArena.release();
+                    boost::json::error_code ec;
+                    boost::json::value json =
+                        boost::json::parse(text, ec, &lineArena);
+                    if (ec) {
+                        reject(line, "JSON parsing failed: " + ec.message());
+                        return;
+                    }
+                    loadRow(line, json);
+                });
+        }
+        loader.finish();
+
+        // Rows the database refused (e.g. an overlapping stay) are
+        // reported like invalid ones
+        errors.insert(errors.end(), loader.rejected().begin(),
+                      loader.rejected().end());
+        if (loader.inserted() > 0) {
+            db->noteWrite(currentClient);
+            httpResponse.result(http::status::ok);
+        } else {
+            httpResponse.result(http::status::bad_request);
+        }
+        bulkResult(httpResponse, loader, errors);
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        // The connection failed: chunks committed before stay loaded
+        httpResponse.result(http::status::internal_server_error);
+        httpResponse.body() = std::string("Error: bulk load failed: ") +
+                              e.what();
+        std::cerr << "[RequestHandler] EXCEPTION in handleBatchPostHTTP: "
+                  << e.what() << "\n";
+    }
+}
+
+void RequestHandler::handleGetHTTP(const PathParams& params,
+                                   const HttpRequest&,
+                                   HttpResponse& httpResponse) {
+    try {
+        int id = params[0].number;
+        if (cache != nullptr && cache->get(id, httpResponse.body())) {
+            httpResponse.result(http::status::ok);
+            return;
+        }
+        // Taken before the read: a PUT or DELETE landing in between makes
+        // the store below a no-op instead of caching the old version
+        std::uint64_t epoch = cache != nullptr ? cache->epoch(id) : 0;
+        // A lagging replica can return the version a write has just
+        // replaced, under the new epoch: its reads of a reservation written
+        // within the lag bound are not cached
+        bool lagging = db->readsFromReplica(currentClient);
+
+        Reservation currentRes = db->withReadConnection(
+            currentClient, [this, id](pqxx::connection& conn) {
+                return db->getReservationById(conn, id);
+            });
+        httpResponse.result(http::status::ok);
+        jsonHandler.reservationToJson(currentRes, httpResponse.body());
+        if (cache != nullptr) {
+            cache->putIfUnchanged(id, httpResponse.body(), epoch, lagging);
+        }
+    } catch (const ReservationNotFound&) {
+        httpResponse.result(http::status::not_found);
+        httpResponse.body() = "Reservation not found";
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const pqxx::broken_connection& e) {
+        // Lost on the primary too, after any replica fallback
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        httpResponse.result(http::status::internal_server_error);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        std::cerr << "[RequestHandler] EXCEPTION in handleGetHTTP: "
+                  << e.what() << "\n";
+    }
+}
+void RequestHandler::handlePutHTTP(const PathParams& params,
+                                   const HttpRequest& httpRequest,
+                                   HttpResponse& httpResponse) {
+    try {
+        int id = params[0].number;
+
+        const Reservation& updated = parseReservation(httpRequest);
+        auto conn = db->getConnectionPool()->acquire();
+        bool found = db->updateReservation(*conn, id, updated);
+        db->noteWrite(currentClient);
+        if (cache != nullptr) {
+            cache->erase(id);
+        }
+        if (found) {
+            httpResponse.result(http::status::ok);
+            httpResponse.body() = "Reservation updated";
+        } else {
+            httpResponse.result(http::status::not_found);
+            httpResponse.body() = "Reservation not found";
+        }
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = std::string("Error: ") + e.what();
+    }
+}
+void RequestHandler::handleDeleteHTTP(const PathParams& params,
+                                      const HttpRequest&,
+                                      HttpResponse& httpResponse) {
+    try {
+        int id = params[0].number;
+
+        auto conn = db->getConnectionPool()->acquire();
+        bool found = db->deleteReservation(*conn, id);
+        db->noteWrite(currentClient);
+        if (cache != nullptr) {
+            cache->erase(id);
+        }
+        if (found) {
+            httpResponse.result(http::status::ok);
+            httpResponse.body() = "Reservation deleted";
+        } else {
+            httpResponse.result(http::status::not_found);
+            httpResponse.body() = "Reservation not found";
+        }
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = std::string("Error: ") + e.what();
+    }
+}
+
+void RequestHandler::handleSearchHTTP(const PathParams&,
+                                      const HttpRequest& httpRequest,
+                                      HttpResponse& httpResponse) {
+    ReservationSearch search;
+    try {
+        search = parseSearch(targetOf(httpRequest));
+    } catch (const std::invalid_argument& e) {
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        return;
+    }
+    try {
+        // Rows go straight from the result into the response body
+        std::string& body = httpResponse.body();
+        auto next = db->withReadConnection(
+            currentClient, [&](pqxx::connection& conn) {
+                jsonHandler.beginReservationList(body);
+                return db->visitReservations(
+                    conn, search, [&](int id, const Reservation& res) {
+                        jsonHandler.appendReservationItem(id, res, body);
+                    });
+            });
+        jsonHandler.endReservationList(
+            body, next ? PageCursor::encode(search.order, *next) : "");
+        httpResponse.result(http::status::ok);
+        httpResponse.set(http::field::content_type, "application/json");
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        httpResponse.result(http::status::internal_server_error);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        std::cerr << "[RequestHandler] EXCEPTION in handleSearchHTTP: "
+                  << e.what() << "\n";
+    }
+}
+
+void RequestHandler::handleExportHTTP(const PathParams&,
+                                      const HttpRequest& httpRequest,
+                                      HttpResponse& httpResponse) {
+    ReservationSearch search;
+    ExportFormat format = ExportFormat::Csv;
+    try {
+        auto target = targetOf(httpRequest);
+        search = parseSearch(target, false);
+        auto formatParam = QueryString(target).get("format");
+        if (formatParam && *formatParam == "ndjson") {
+            format = ExportFormat::Ndjson;
+        } else if (formatParam && *formatParam != "csv") {
+            throw std::invalid_argument("format must be csv or ndjson");
+        }
+    } catch (const std::invalid_argument& e) {
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        return;
+    }
+    try {
+        // Only the COPY is started here: the rows are read while the body
+        // is written, one piece at a time
+        auto source = db->exportReservations(
+            db->acquireReadConnection(currentClient), search, format);
+        streamedBody = std::make_unique<ExportBody>(std::move(source));
+        httpResponse.result(http::status::ok);
+        if (format == ExportFormat::Csv) {
+            httpResponse.set(http::field::content_type, "text/csv");
+            httpResponse.set(http::field::content_disposition,
+                             "attachment; filename=\"reservations.csv\"");
+        } else {
+            httpResponse.set(http::field::content_type,
+                             "application/x-ndjson");
+        }
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        httpResponse.result(http::status::internal_server_error);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        std::cerr << "[RequestHandler] EXCEPTION in handleExportHTTP: "
+                  << e.what() << "\n";
+    }
+}
+
+void RequestHandler::handleAvailabilityHTTP(const PathParams& params,
+                                            const HttpRequest& httpRequest,
+                                            HttpResponse& httpResponse) {
+    int room = params[0].number;
+    std::string from;
+    std::string to;
+    try {
+        QueryString query(targetOf(httpRequest));
+        auto fromParam = query.get("from");
+        auto toParam = query.get("to");
+        if (!fromParam || !toParam) {
+            throw std::invalid_argument("from and to are required");
+        }
+        from = dateParam("from", *fromParam);
+        to = dateParam("to", *toParam);
+        if (from >= to) {
+            throw std::invalid_argument("from must be before to");
+        }
+    } catch (const std::invalid_argument& e) {
+        httpResponse.result(http::status::bad_request);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        return;
+    }
+    try {
+        auto conflicts = db->withReadConnection(
+            currentClient, [&](pqxx::connection& conn) {
+                return db->overlappingReservations(conn, room, from, to);
+            });
+        boost::json::object result;
+        result["room_number"] = room;
+        result["from"] = from;
+        result["to"] = to;
+        result["available"] = conflicts.empty();
+        boost::json::array ids;
+        for (int id : conflicts) {
+            ids.push_back(id);
+        }
+        result["conflicts"] = std::move(ids);
+        httpResponse.result(http::status::ok);
+        httpResponse.set(http::field::content_type, "application/json");
+        httpResponse.body() = boost::json::serialize(result);
+    } catch (const PoolUnavailable& e) {
+        databaseUnavailable(httpResponse, e);
+    } catch (const std::exception& e) {
+        httpResponse.result(http::status::internal_server_error);
+        httpResponse.body() = std::string("Error: ") + e.what();
+        std::cerr << "[RequestHandler] EXCEPTION in handleAvailabilityHTTP: "
+                  << e.what() << "\n";
+    }
+}
+
+void RequestHandler::handleMetricsHTTP(const PathParams&, const HttpRequest&,
+                                       HttpResponse& httpResponse) {
+    if (metrics == nullptr) {
+        httpResponse.result(http::status::not_found);
+        httpResponse.body() = "Endpoint not found";
+        return;
+    }
+    httpResponse.result(http::status::ok);
+    httpResponse.set(http::field::content_type, "text/plain; version=0.0.4");
+    httpResponse.body() = metrics->render();
+}
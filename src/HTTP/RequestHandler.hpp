@@ -0,0 +1,137 @@
+#ifndef REQUESTHANDLER_HPP
+#define REQUESTHANDLER_HPP
+
+// HTTP messages
+#include <boost/beast/http.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "../DataBase/PostgresDB.hpp"
+#include "../Utils/ShardedLruCache.hpp"
+#include "JsonHandler.hpp"
+#include "RequestBody.hpp"
+#include "Router.hpp"
+#include "ServerMetrics.hpp"
+
+// alias
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+// JSON bodies arrive already parsed, see RequestBody
+using HttpRequest = http::request<RequestBody>;
+using HttpResponse = http::response<http::string_body>;
+// GET response bodies (reservation JSON) by reservation ID
+using ReservationCache = ShardedLruCache<int, std::string>;
+
+// Body of a response too large to build in memory: produced piece by piece
+// after the header went out, and sent with chunked transfer encoding
+class ResponseStream {
+   public:
+    virtual ~ResponseStream() = default;
+
+    // Replaces out with the next piece of the body (possibly empty).
+    // Blocks like the handlers do, and may throw: the body is then cut
+    // short and the connection closed.
+    // return: false once out holds the last piece
+    virtual bool next(std::string& out) = 0;
+};
+
+// Turns one parsed HTTP request into its response: dispatches on method and
+// target, through a route table built at compile time, to the reservation
+// handlers (POST, batch POST, GET, PUT, DELETE, search, availability,
+// export),
+// which do the JSON and database work, or to GET /metrics. Holds no
+// per-request state, so one instance is shared by every connection of the
+// server, whatever session engine runs it.
+// Handlers block on the database; callers decide which thread pays for that.
+class RequestHandler {
+   public:
+    // metrics: exposed on GET /metrics when not null (owned by the server)
+    // cache: serves GET by ID when not null; PUT and DELETE invalidate it
+    explicit RequestHandler(PostgresDB* database = nullptr,
+                            const ServerMetrics* metrics = nullptr,
+                            ReservationCache* cache = nullptr);
+
+    // Fills httpResponse (status and body) for httpRequest. Never throws:
+    // errors are reported as HTTP error responses.
+    // clientAddress: who sent the request; reads that follow a write of the
+    // same client go to the primary database (PostgresDB::noteWrite)
+    // return: the body, when it is streamed (exports): httpResponse then
+    // only holds the status and headers. nullptr otherwise.
+    std::unique_ptr<ResponseStream> handle(const HttpRequest& httpRequest,
+                                           HttpResponse& httpResponse,
+                                           std::string_view clientAddress = {});
+
+    // Bulk ingestion endpoint; its requests get a larger body limit
+    static constexpr std::string_view kBulkPath =
+        "/application/reservations/batch";
+    // True when target (query string ignored) is kBulkPath
+    static bool isBulkTarget(std::string_view target);
+
+   private:
+    // Every endpoint has this signature so the route table can hold them
+    using Endpoint = void (RequestHandler::*)(const PathParams&,
+                                              const HttpRequest&,
+                                              HttpResponse&);
+    static constexpr std::size_t kRouteCount = 9;
+    static const Router<Endpoint, kRouteCount> router;
+
+    JsonHandler jsonHandler;
+    PostgresDB* db;
+    const ServerMetrics* metrics;
+    ReservationCache* cache;
+
+    // Reservation from a request body, streamed JSON or text. Throws
+    // std::invalid_argument like JsonHandler::parseJson, or its subclass
+    // StayOutsidePartitions (PostgresDB::checkStay). The result is a
+    // per-thread scratch object, valid until the next call on this thread.
+    const Reservation& parseReservation(const HttpRequest& httpRequest);
+    // HTTP POST new reservation
+    void handlePostHTTP(const PathParams& params,
+                        const HttpRequest& httpRequest,
+                        HttpResponse& httpResponse);
+    // HTTP POST many reservations at once: a JSON array, or one JSON
+    // object per line (NDJSON) for any other content type. Rows are checked
+    // one by one, the valid ones are loaded with COPY.
+    void handleBatchPostHTTP(const PathParams& params,
+                             const HttpRequest& httpRequest,
+                             HttpResponse& httpResponse);
+    // HTTP GET reservation {id}
+    void handleGetHTTP(const PathParams& params,
+                       const HttpRequest& httpRequest,
+                       HttpResponse& httpResponse);
+    // HTTP PUT (update reservation {id})
+    void handlePutHTTP(const PathParams& params,
+                       const HttpRequest& httpRequest,
+                       HttpResponse& httpResponse);
+    // HTTP DELETE reservation {id}
+    void handleDeleteHTTP(const PathParams& params,
+                          const HttpRequest& httpRequest,
+                          HttpResponse& httpResponse);
+    // HTTP GET reservations matching the query string: room_number, from
+    // and to (stays overlapping those days), status, limit, order (id or
+    // check_in_date). Answers {"items":[...]}, plus "next_cursor" when
+    // more rows follow: passed back as ?cursor=, with the same filters and
+    // order, it gives the next page.
+    void handleSearchHTTP(const PathParams& params,
+                          const HttpRequest& httpRequest,
+                          HttpResponse& httpResponse);
+    // HTTP GET every reservation matching the search filters (no limit,
+    // order or cursor), by ID, as ?format=csv (default) or ndjson. The
+    // body is streamed from a COPY (PostgresDB::exportReservations).
+    void handleExportHTTP(const PathParams& params,
+                          const HttpRequest& httpRequest,
+                          HttpResponse& httpResponse);
+    // HTTP GET whether room {room} is free for a stay ?from=...&to=...,
+    // with the IDs of the reservations in the way
+    void handleAvailabilityHTTP(const PathParams& params,
+                                const HttpRequest& httpRequest,
+                                HttpResponse& httpResponse);
+    // HTTP GET server metrics (Prometheus text format)
+    void handleMetricsHTTP(const PathParams& params,
+                           const HttpRequest& httpRequest,
+                           HttpResponse& httpResponse);
+};
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef ROUTER_HPP
+#define ROUTER_HPP
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+// HTTP verbs
+#include <boost/beast/http.hpp>
+
+// alias
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+// Type of a "{name:type}" path segment; "{name}" is a String parameter
+enum class ParamType { None, Int, String };
+
+// One path parameter of a matched route. text points into the request
+// target, so it is only valid as long as the request is. number holds the
+// value of an Int parameter.
+struct PathParam {
+    std::string_view name;
+    std::string_view text;
+    int number = 0;
+};
+
+// Parameters of a matched route in pattern order. Fixed capacity, so
+// matching a request never allocates.
+class PathParams {
+   public:
+    static constexpr std::size_t kMaxParams = 4;
+
+    const PathParam& operator[](std::size_t index) const {
+        return params[index];
+    }
+    std::size_t size() const { return count; }
+    // nullptr if the route has no parameter with that name
+    const PathParam* find(std::string_view name) const {
+        for (std::size_t i = 0; i < count; i++) {
+            if (params[i].name == name) {
+                return &params[i];
+            }
+        }
+        return nullptr;
+    }
+
+   private:
+    template <typename, std::size_t>
+    friend class Router;
+
+    std::array<PathParam, kMaxParams> params{};
+    std::size_t count = 0;
+};
+
+enum class RouteStatus {
+    Matched,
+    // No route for this verb and path
+    NotFound,
+    // The path matches a route but a typed parameter does not parse, e.g.
+    // "abc" or an out of range number for {id:int}
+    InvalidParameter
+};
+
+// One entry of a route table: pattern is a path such as
+// "/application/reservation/{id:int}"
+template <typename Handler>
+struct Route {
+    http::verb verb;
+    std::string_view pattern;
+    Handler handler;
+};
+
+template <typename Handler>
+struct RouteMatch {
+    RouteStatus status = RouteStatus::NotFound;
+    Handler handler{};
+    PathParams params;
+};
+
+// Dispatch table built at compile time from a fixed list of routes: one
+// path-segment trie per HTTP verb, stored in a flat array of nodes. Literal
+// segments win over a parameter at the same position. Malformed or
+// conflicting patterns throw std::invalid_argument, which is a compile
+// error when the router is a constexpr variable.
+//
+// Adding a route is adding a line to the table; match() only compares
+// string_views and never allocates.
+template <typename Handler, std::size_t RouteCount>
+class Router {
+   public:
+    static constexpr std::size_t kMaxSegments = 8;
+
+    constexpr explicit Router(
+        const std::array<Route<Handler>, RouteCount>& table)
+        : routes(table) {
+        roots.fill(-1);
+        for (std::size_t i = 0; i < RouteCount; i++) {
+            insert(static_cast<int>(i));
+        }
+    }
+
+    // target is the request target; its query string is ignored
+    RouteMatch<Handler> match(http::verb verb, std::string_view target) const {
+        RouteMatch<Handler> result;
+        auto verbIndex = static_cast<std::size_t>(verb);
+        if (verbIndex >= roots.size() || roots[verbIndex] < 0) {
+            return result;
+        }
+        target = target.substr(0, target.find('?'));
+        if (target.empty() || target.front() != '/') {
+            return result;
+        }
+
+        int node = roots[verbIndex];
+        bool invalidParameter = false;
+        std::string_view path = target.substr(1);
+        std::size_t begin = 0;
+        bool more = !path.empty();
+        while (more) {
+            std::size_t slash = path.find('/', begin);
+            std::string_view segment = path.substr(begin, slash - begin);
+            more = slash != std::string_view::npos;
+            begin = slash + 1;
+
+            int child = findChild(node, segment, ParamType::None);
+            if (child < 0) {
+                child = findParamChild(node);
+                if (child < 0) {
+                    return result;
+                }
+                PathParam& param = result.params.params[result.params.count++];
+                param.name = nodes[child].segment;
+                param.text = segment;
+                if (nodes[child].paramType == ParamType::Int &&
+                    !parseInt(segment, param.number)) {
+                    invalidParameter = true;
+                }
+            }
+            node = child;
+        }
+
+        if (nodes[node].route < 0) {
+            result.params.count = 0;
+            return result;
+        }
+        result.status = invalidParameter ? RouteStatus::InvalidParameter
+                                         : RouteStatus::Matched;
+        result.handler = routes[nodes[node].route].handler;
+        return result;
+    }
+
+   private:
+    struct Node {
+        // Literal text, or the parameter name when paramType is not None
+        std::string_view segment;
+        ParamType paramType = ParamType::None;
+        int firstChild = -1;
+        int nextSibling = -1;
+        // Index in routes of the route ending here, -1 if none
+        int route = -1;
+    };
+
+    static constexpr std::size_t kVerbCount =
+        static_cast<std::size_t>(http::verb::unlink) + 1;
+
+    std::array<Route<Handler>, RouteCount> routes;
+    // Every route adds at most its verb root and kMaxSegments nodes
+    std::array<Node, RouteCount * (kMaxSegments + 1)> nodes{};
+    std::size_t nodeCount = 0;
+    std::array<int, kVerbCount> roots{};
+
+    constexpr int addNode(const Node& node) {
+        nodes[nodeCount] = node;
+        return static_cast<int>(nodeCount++);
+    }
+
+    constexpr void insert(int routeIndex) {
+        const Route<Handler>& route = routes[routeIndex];
+        auto verbIndex = static_cast<std::size_t>(route.verb);
+        if (route.verb == http::verb::unknown || verbIndex >= kVerbCount) {
+            throw std::invalid_argument("Router: route without a verb");
+        }
+        if (route.pattern.empty() || route.pattern.front() != '/') {
+            throw std::invalid_argument("Router: pattern must start with /");
+        }
+        if (roots[verbIndex] < 0) {
+            roots[verbIndex] = addNode(Node{});
+        }
+
+        int node = roots[verbIndex];
+        std::size_t segments = 0;
+        std::size_t params = 0;
+        std::string_view path = route.pattern.substr(1);
+        std::size_t begin = 0;
+        bool more = !path.empty();
+        while (more) {
+            std::size_t slash = path.find('/', begin);
+            Node segment = parseSegment(path.substr(begin, slash - begin));
+            more = slash != std::string_view::npos;
+            begin = slash + 1;
+
+            if (++segments > kMaxSegments) {
+                throw std::invalid_argument("Router: too many segments");
+            }
+            if (segment.paramType != ParamType::None &&
+                ++params > PathParams::kMaxParams) {
+                throw std::invalid_argument("Router: too many parameters");
+            }
+            node = addChild(node, segment);
+        }
+
+        if (nodes[node].route >= 0) {
+            throw std::invalid_argument("Router: duplicate route");
+        }
+        nodes[node].route = routeIndex;
+    }
+
+    // "{name:int}", "{name:string}", "{name}" or a literal segment
+    static constexpr Node parseSegment(std::string_view text) {
+        Node node;
+        if (text.empty() || text.front() != '{') {
+            node.segment = text;
+            return node;
+        }
+        if (text.back() != '}') {
+            throw std::invalid_argument("Router: unterminated parameter");
+        }
+        text = text.substr(1, text.size() - 2);
+        std::size_t colon = text.find(':');
+        node.segment = text.substr(0, colon);
+        std::string_view type =
+            colon == std::string_view::npos ? "string" : text.substr(colon + 1);
+        if (node.segment.empty()) {
+            throw std::invalid_argument("Router: unnamed parameter");
+        }
+        if (type == "int") {
+            node.paramType = ParamType::Int;
+        } else if (type == "string") {
+            node.paramType = ParamType::String;
+        } else {
+            throw std::invalid_argument("Router: unknown parameter type");
+        }
+        return node;
+    }
+
+    constexpr int addChild(int parent, const Node& segment) {
+        if (segment.paramType != ParamType::None) {
+            int existing = findParamChild(parent);
+            if (existing >= 0) {
+                // Two routes may share a parameter, not disagree about it
+                if (nodes[existing].segment != segment.segment ||
+                    nodes[existing].paramType != segment.paramType) {
+                    throw std::invalid_argument(
+                        "Router: conflicting parameters");
+                }
+                return existing;
+            }
+        } else {
+            int existing =
+                findChild(parent, segment.segment, ParamType::None);
+            if (existing >= 0) {
+                return existing;
+            }
+        }
+        Node child = segment;
+        child.nextSibling = nodes[parent].firstChild;
+        int index = addNode(child);
+        nodes[parent].firstChild = index;
+        return index;
+    }
+
+    constexpr int findChild(int parent, std::string_view segment,
+                            ParamType type) const {
+        for (int child = nodes[parent].firstChild; child >= 0;
+             child = nodes[child].nextSibling) {
+            if (nodes[child].paramType == type &&
+                nodes[child].segment == segment) {
+                return child;
+            }
+        }
+        return -1;
+    }
+
+    constexpr int findParamChild(int parent) const {
+        for (int child = nodes[parent].firstChild; child >= 0;
+             child = nodes[child].nextSibling) {
+            if (nodes[child].paramType != ParamType::None) {
+                return child;
+            }
+        }
+        return -1;
+    }
+
+    // Whole segment must be a number that fits in an int
+    static bool parseInt(std::string_view text, int& value) {
+        const char* end = text.data() + text.size();
+        auto [ptr, ec] = std::from_chars(text.data(), end, value);
+        return !text.empty() && ec == std::errc() && ptr == end;
+    }
+};
+
+#endif
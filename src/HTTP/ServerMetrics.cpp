@@ -0,0 +1,79 @@
+#include "ServerMetrics.hpp"
+
+#include <sstream>
+
+namespace {
+
+// The ConnectionPool::Stats lines, each name starting with prefix
+void renderPool(std::ostringstream& out, const char* prefix,
+                const ConnectionPool::Stats& pool) {
+    out << prefix << "connections " << pool.size << "\n";
+    out << prefix << "max_connections " << pool.maxSize << "\n";
+    out << prefix << "idle_connections " << pool.idle << "\n";
+    out << prefix << "acquired_total " << pool.acquired << "\n";
+    out << prefix << "acquire_timeouts_total " << pool.timeouts << "\n";
+    out << prefix << "acquire_wait_seconds_total "
+        << static_cast<double>(pool.waitMicroseconds) / 1e6 << "\n";
+    out << prefix << "reconnects_total " << pool.reconnects << "\n";
+    out << prefix << "reconnect_failures_total " << pool.reconnectFailures
+        << "\n";
+    out << prefix << "grown_total " << pool.grown << "\n";
+    out << prefix << "reaped_total " << pool.reaped << "\n";
+}
+
+}  // namespace
+
+std::string ServerMetrics::render() const {
+    std::ostringstream out;
+    out << "http_accepted_connections_total " << acceptedConnections.load()
+        << "\n";
+    out << "http_rejected_connections_total " << rejectedConnections.load()
+        << "\n";
+    out << "http_rejected_requests_total " << rejectedRequests.load() << "\n";
+    out << "http_timed_out_connections_total " << timedOutConnections.load()
+        << "\n";
+    out << "http_queue_depth " << (queueDepth ? queueDepth() : 0) << "\n";
+    out << "http_queue_capacity " << (queueCapacity ? queueCapacity() : 0)
+        << "\n";
+    if (shardAcceptCounts) {
+        auto counts = shardAcceptCounts();
+        for (std::size_t shard = 0; shard < counts.size(); shard++) {
+            out << "http_shard_accepted_connections_total{shard=\"" << shard
+                << "\"} " << counts[shard] << "\n";
+        }
+    }
+    if (databasePool) {
+        renderPool(out, "db_pool_", databasePool());
+    }
+    if (readPool) {
+        renderPool(out, "db_read_pool_", readPool());
+    }
+    if (readRouting) {
+        ReadRoutingStats reads = readRouting();
+        out << "db_replica_reads_total " << reads.replicaReads << "\n";
+        out << "db_read_your_writes_primary_reads_total "
+            << reads.primaryReads << "\n";
+        out << "db_replica_fallbacks_total " << reads.fallbacks << "\n";
+    }
+    if (insertBatches) {
+        InsertBatcher::Stats batches = insertBatches();
+        out << "db_insert_batches_total " << batches.batches << "\n";
+        out << "db_insert_batched_rows_total " << batches.rows << "\n";
+        out << "db_insert_batch_fallbacks_total " << batches.fallbacks
+            << "\n";
+    }
+    if (reservationCache) {
+        auto cache = reservationCache();
+        out << "reservation_cache_hits_total " << cache.hits << "\n";
+        out << "reservation_cache_misses_total " << cache.misses << "\n";
+        out << "reservation_cache_evictions_total " << cache.evictions
+            << "\n";
+        out << "reservation_cache_expirations_total " << cache.expirations
+            << "\n";
+        out << "reservation_cache_invalidations_total " << cache.invalidations
+            << "\n";
+        out << "reservation_cache_entries " << cache.size << "\n";
+        out << "reservation_cache_capacity " << cache.capacity << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,51 @@
+#ifndef SERVERMETRICS_HPP
+#define SERVERMETRICS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../DataBase/InsertBatcher.hpp"
+#include "../DataBase/ReadRouting.hpp"
+#include "../Utils/ConnectionPool.hpp"
+#include "../Utils/ShardedLruCache.hpp"
+
+// Counters shared by HttpServer, its sessions and the GET /metrics endpoint.
+// Counters are atomics bumped from any thread; gauges are sampled through
+// callbacks installed by the owner of the measured object.
+struct ServerMetrics {
+    // Connections accepted by the listener(s), rejected ones included
+    std::atomic<std::uint64_t> acceptedConnections{0};
+    // Connections answered with 503 at accept time because the ThreadPool
+    // queue was full (ThreadPool engine)
+    std::atomic<std::uint64_t> rejectedConnections{0};
+    // Requests answered with 503 because the ThreadPool queue was full
+    // (Coroutine engine, where the queue holds request handler work)
+    std::atomic<std::uint64_t> rejectedRequests{0};
+    // Connections closed because a header, body or write deadline expired
+    // (an idle keep-alive connection reaching its timeout is not counted)
+    std::atomic<std::uint64_t> timedOutConnections{0};
+
+    // ThreadPool queue depth and capacity (0 = unbounded)
+    std::function<std::size_t()> queueDepth;
+    std::function<std::size_t()> queueCapacity;
+    // Connections accepted by each SO_REUSEPORT shard (Sharded mode)
+    std::function<std::vector<std::uint64_t>()> shardAcceptCounts;
+    // Database connection pool usage (only with a database)
+    std::function<ConnectionPool::Stats()> databasePool;
+    // Read replica pool and where reads went (only with DB_READ_HOST)
+    std::function<ConnectionPool::Stats()> readPool;
+    std::function<ReadRoutingStats()> readRouting;
+    // Group-commit inserts (only with DB_INSERT_BATCH_SIZE > 1)
+    std::function<InsertBatcher::Stats()> insertBatches;
+    // GET reservation cache (only with SERVER_CACHE_ENTRIES > 0)
+    std::function<ShardedLruCache<int, std::string>::Stats()>
+        reservationCache;
+
+    // Prometheus text exposition format, one "name value" line per metric
+    std::string render() const;
+};
+
+#endif
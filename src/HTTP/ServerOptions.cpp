@@ -0,0 +1,160 @@
+#include "ServerOptions.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+AcceptMode parseAcceptMode(const std::string& value) {
+    if (value == "blocking") {
+        return AcceptMode::Blocking;
+    }
+    if (value == "async") {
+        return AcceptMode::Async;
+    }
+    if (value == "sharded") {
+        return AcceptMode::Sharded;
+    }
+    throw std::invalid_argument("SERVER_ACCEPT_MODE must be 'blocking', "
+                                "'async' or 'sharded', got: '" +
+                                value + "'");
+}
+
+SessionEngine parseSessionEngine(const std::string& value) {
+    if (value == "threadpool") {
+        return SessionEngine::ThreadPool;
+    }
+    if (value == "coroutine") {
+        return SessionEngine::Coroutine;
+    }
+    throw std::invalid_argument("SERVER_SESSION_ENGINE must be 'threadpool' "
+                                "or 'coroutine', got: '" +
+                                value + "'");
+}
+
+void requirePositive(int value, const std::string& what,
+                     const std::string& key) {
+    if (value <= 0) {
+        throw std::invalid_argument("Invalid " + what + ": " +
+                                    std::to_string(value) + ". " + key +
+                                    " must be greater than 0");
+    }
+}
+
+}  // namespace
+
+ServerOptions ServerOptions::fromConfig(const ConfigManager& config) {
+    ServerOptions options;
+    options.acceptMode =
+        parseAcceptMode(config.get("SERVER_ACCEPT_MODE", "blocking"));
+    options.sessionEngine =
+        parseSessionEngine(config.get("SERVER_SESSION_ENGINE", "threadpool"));
+    options.ioThreads = config.getInt("SERVER_IO_THREADS", options.ioThreads);
+    options.shards = config.getInt("SERVER_SHARDS", options.shards);
+    options.workerThreads =
+        config.getInt("SERVER_WORKER_THREADS", options.workerThreads);
+    options.queueCapacity =
+        config.getInt("SERVER_QUEUE_CAPACITY", options.queueCapacity);
+    options.retryAfterSeconds =
+        config.getInt("SERVER_RETRY_AFTER_SECONDS", options.retryAfterSeconds);
+    options.keepAliveTimeoutMs = config.getInt("SERVER_KEEPALIVE_TIMEOUT_MS",
+                                               options.keepAliveTimeoutMs);
+    options.maxRequestsPerConnection =
+        config.getInt("SERVER_MAX_REQUESTS_PER_CONNECTION",
+                      options.maxRequestsPerConnection);
+    options.headerTimeoutMs =
+        config.getInt("SERVER_HEADER_TIMEOUT_MS", options.headerTimeoutMs);
+    options.bodyTimeoutMs =
+        config.getInt("SERVER_BODY_TIMEOUT_MS", options.bodyTimeoutMs);
+    options.writeTimeoutMs =
+        config.getInt("SERVER_WRITE_TIMEOUT_MS", options.writeTimeoutMs);
+    options.maxBodyBytes =
+        config.getInt("SERVER_MAX_BODY_BYTES", options.maxBodyBytes);
+    options.maxBulkBodyBytes =
+        config.getInt("SERVER_MAX_BULK_BODY_BYTES", options.maxBulkBodyBytes);
+    options.cacheEntries =
+        config.getInt("SERVER_CACHE_ENTRIES", options.cacheEntries);
+    options.cacheTtlMs =
+        config.getInt("SERVER_CACHE_TTL_MS", options.cacheTtlMs);
+    options.cacheShards =
+        config.getInt("SERVER_CACHE_SHARDS", options.cacheShards);
+    options.clientHeader = config.get("SERVER_CLIENT_HEADER", "");
+    options.validate();
+    return options;
+}
+
+void ServerOptions::validate() const {
+    if (ioThreads <= 0) {
+        throw std::invalid_argument(
+            "Invalid io thread count: " + std::to_string(ioThreads) +
+            ". SERVER_IO_THREADS must be greater than 0");
+    }
+    if (shards < 0) {
+        throw std::invalid_argument(
+            "Invalid shard count: " + std::to_string(shards) +
+            ". SERVER_SHARDS must be 0 (one per core) or greater");
+    }
+    if (workerThreads <= 0) {
+        throw std::invalid_argument(
+            "Invalid worker thread count: " + std::to_string(workerThreads) +
+            ". SERVER_WORKER_THREADS must be greater than 0");
+    }
+    if (queueCapacity < 0) {
+        throw std::invalid_argument(
+            "Invalid queue capacity: " + std::to_string(queueCapacity) +
+            ". SERVER_QUEUE_CAPACITY must be 0 (unbounded) or greater");
+    }
+    if (retryAfterSeconds < 0) {
+        throw std::invalid_argument(
+            "Invalid Retry-After: " + std::to_string(retryAfterSeconds) +
+            ". SERVER_RETRY_AFTER_SECONDS must not be negative");
+    }
+    if (keepAliveTimeoutMs <= 0) {
+        throw std::invalid_argument(
+            "Invalid keep-alive timeout: " +
+            std::to_string(keepAliveTimeoutMs) +
+            ". SERVER_KEEPALIVE_TIMEOUT_MS must be greater than 0");
+    }
+    if (maxRequestsPerConnection <= 0) {
+        throw std::invalid_argument(
+            "Invalid request limit: " +
+            std::to_string(maxRequestsPerConnection) +
+            ". SERVER_MAX_REQUESTS_PER_CONNECTION must be greater than 0");
+    }
+    requirePositive(headerTimeoutMs, "header timeout",
+                    "SERVER_HEADER_TIMEOUT_MS");
+    requirePositive(bodyTimeoutMs, "body timeout", "SERVER_BODY_TIMEOUT_MS");
+    requirePositive(writeTimeoutMs, "write timeout",
+                    "SERVER_WRITE_TIMEOUT_MS");
+    requirePositive(maxBodyBytes, "body limit", "SERVER_MAX_BODY_BYTES");
+    requirePositive(maxBulkBodyBytes, "bulk body limit",
+                    "SERVER_MAX_BULK_BODY_BYTES");
+    if (cacheEntries < 0) {
+        throw std::invalid_argument(
+            "Invalid cache size: " + std::to_string(cacheEntries) +
+            ". SERVER_CACHE_ENTRIES must be 0 (no cache) or greater");
+    }
+    if (cacheTtlMs < 0) {
+        throw std::invalid_argument(
+            "Invalid cache TTL: " + std::to_string(cacheTtlMs) +
+            ". SERVER_CACHE_TTL_MS must not be negative");
+    }
+    requirePositive(cacheShards, "cache shard count", "SERVER_CACHE_SHARDS");
+}
+
+bool ServerOptions::usesIoThreads() const {
+    if (acceptMode == AcceptMode::Sharded) {
+        return false;
+    }
+    return acceptMode == AcceptMode::Async ||
+           sessionEngine == SessionEngine::Coroutine;
+}
+
+int ServerOptions::shardCount() const {
+    if (shards > 0) {
+        return shards;
+    }
+    // hardware_concurrency() may report 0 when it cannot tell
+    return std::max(1u, std::thread::hardware_concurrency());
+}
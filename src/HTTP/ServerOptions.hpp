@@ -0,0 +1,119 @@
+#ifndef SERVEROPTIONS_HPP
+#define SERVEROPTIONS_HPP
+
+#include <string>
+
+#include "../config/ConfigManager.hpp"
+
+// How HttpServer picks up new TCP connections.
+enum class AcceptMode {
+    // accept() loop on the thread that called start(). The io_context is not
+    // run while serving, exactly like the original server.
+    Blocking,
+    // async_accept() chain on the io_context, which is run by ioThreads
+    // threads, so accepting keeps up with connection bursts.
+    Async,
+    // shards acceptors bound to the same port with SO_REUSEPORT, each with
+    // its own io_context and thread pinned to a core. The kernel spreads new
+    // connections across them, so there is no shared accept lock (Linux).
+    Sharded
+};
+
+// What serves an accepted connection.
+enum class SessionEngine {
+    // One ThreadPool worker per connection, blocked on its reads and writes
+    // for as long as the connection lives (the original model).
+    ThreadPool,
+    // One asio::awaitable coroutine per connection on the io threads. Only
+    // request handling (the blocking database work) is handed to the
+    // ThreadPool, so idle connections cost memory but no thread. Implies
+    // async accepting.
+    Coroutine
+};
+
+// Tuning knobs for HttpServer. The defaults reproduce the historical
+// behaviour, so HttpServer(db, port) keeps working unchanged.
+struct ServerOptions {
+    AcceptMode acceptMode = AcceptMode::Blocking;
+    SessionEngine sessionEngine = SessionEngine::ThreadPool;
+    // Threads running io_context::run() in Async mode (including the caller
+    // of start()). Ignored in Blocking mode.
+    int ioThreads = 1;
+    // Listener shards in Sharded mode; 0 means one per hardware thread
+    int shards = 0;
+    // ThreadPool size: concurrent connections with the ThreadPool engine,
+    // concurrent database calls with the Coroutine engine
+    int workerThreads = 4;
+    // Admission control: ThreadPool tasks (connections with the ThreadPool
+    // engine, requests with the Coroutine engine) allowed to wait for a
+    // worker. Past that the server answers 503 with a Retry-After of
+    // retryAfterSeconds instead of queueing. 0 = unbounded.
+    int queueCapacity = 0;
+    int retryAfterSeconds = 1;
+    // HTTP/1.1 persistent connections: a connection is closed once it has
+    // been idle for keepAliveTimeoutMs or has served maxRequestsPerConnection
+    // requests. maxRequestsPerConnection = 1 disables keep-alive.
+    int keepAliveTimeoutMs = 5000;
+    int maxRequestsPerConnection = 100;
+    // Deadlines against slow or silent clients, each one closes the
+    // connection when it expires: receiving the first request's headers
+    // (later requests get keepAliveTimeoutMs), receiving a request body once
+    // its headers arrived, and sending a response.
+    int headerTimeoutMs = 5000;
+    int bodyTimeoutMs = 10000;
+    int writeTimeoutMs = 10000;
+    // Largest request body accepted, 413 Payload Too Large beyond it. Bulk
+    // ingestion (POST /application/reservations/batch) has its own limit.
+    int maxBodyBytes = 1024 * 1024;
+    int maxBulkBodyBytes = 256 * 1024 * 1024;
+    // In-memory cache of GET /application/reservation/{id} responses:
+    // entries held (0 = no cache), their time to live (0 = until evicted
+    // or invalidated by a PUT or DELETE) and lock shards
+    int cacheEntries = 0;
+    int cacheTtlMs = 30000;
+    int cacheShards = 16;
+    // Request header naming the client for read-your-writes routing (see
+    // PostgresDB::noteWrite), e.g. X-Forwarded-For behind a proxy or load
+    // balancer, where every client shares the proxy's address. Empty, or
+    // absent from a request, means the peer address.
+    std::string clientHeader;
+
+    /**
+     * Build options from the optional .env keys:
+     *   SERVER_ACCEPT_MODE                 = blocking | async | sharded
+     *   SERVER_SESSION_ENGINE              = threadpool | coroutine
+     *   SERVER_IO_THREADS                  = threads running the io_context
+     *   SERVER_SHARDS                      = SO_REUSEPORT listener shards
+     *   SERVER_WORKER_THREADS              = ThreadPool size
+     *   SERVER_QUEUE_CAPACITY              = queued tasks before 503 (0 = off)
+     *   SERVER_RETRY_AFTER_SECONDS         = Retry-After sent with a 503
+     *   SERVER_KEEPALIVE_TIMEOUT_MS        = idle time before closing
+     *   SERVER_MAX_REQUESTS_PER_CONNECTION = requests served per connection
+     *   SERVER_HEADER_TIMEOUT_MS           = deadline for the first headers
+     *   SERVER_BODY_TIMEOUT_MS             = deadline for a request body
+     *   SERVER_WRITE_TIMEOUT_MS            = deadline for a response
+     *   SERVER_MAX_BODY_BYTES              = largest request body
+     *   SERVER_MAX_BULK_BODY_BYTES         = same, for bulk ingestion
+     *   SERVER_CACHE_ENTRIES               = cached reservations (0 = off)
+     *   SERVER_CACHE_TTL_MS                = age of a cached reservation
+     *   SERVER_CACHE_SHARDS                = independently locked shards
+     *   SERVER_CLIENT_HEADER               = header identifying the client
+     *
+     * Missing keys keep their default value.
+     * throws: std::invalid_argument if a value is out of range
+     */
+    static ServerOptions fromConfig(const ConfigManager& config);
+
+    // Throws std::invalid_argument if any value is out of range
+    void validate() const;
+
+    // True when connections are accepted on the io threads (async accept or
+    // the coroutine engine) rather than by a blocking accept() loop or by
+    // listener shards
+    bool usesIoThreads() const;
+
+    // Number of listener shards to open in Sharded mode (resolves 0)
+    int shardCount() const;
+};
+
+#endif
@@ -1,16 +1,21 @@
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
 #include <queue>
 template <typename T>
 class BlockingQueue {
    private:
     std::queue<T> queue;
-    std::mutex mtx;
+    mutable std::mutex mtx;
     std::condition_variable cv;
     std::atomic<bool> stopped{false};
+    // maximum number of queued items for tryPush(), 0 = unbounded
+    std::size_t capacity;
 
    public:
+    explicit BlockingQueue(std::size_t capacity = 0) : capacity(capacity) {}
+
     void push(T request) {
         // every time we touch the queue, we need to make sure that only one
         // thread have acccess to the queue, so we use a mutex
@@ -20,6 +25,20 @@ class BlockingQueue {
         }
         cv.notify_one();
     }
+    // Like push(), but refuses the item when the queue already holds
+    // capacity items. request is only moved from when it was accepted, so
+    // the caller can still answer it (e.g. with a 503) on failure.
+    bool tryPush(T& request) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (capacity != 0 && queue.size() >= capacity) {
+                return false;
+            }
+            queue.push(std::move(request));
+        }
+        cv.notify_one();
+        return true;
+    }
     // every time we touch the queue, we need to make sure that only one
     // thread have acccess to the queue, so we use a mutex
     bool pop(T& request) {
@@ -32,6 +51,12 @@ class BlockingQueue {
         queue.pop();
         return true;
     }
+    // Number of items waiting to be popped
+    std::size_t size() const {
+        std::unique_lock<std::mutex> lock(mtx);
+        return queue.size();
+    }
+    std::size_t maxSize() const { return capacity; }
     // every time we touch the queue, we need to make sure that only one
     // thread have acccess to the queue, so we use a mutex
     void stop() {
@@ -41,4 +66,4 @@ class BlockingQueue {
         }
         cv.notify_all();
     }
-};
\ No newline at end of file
+};
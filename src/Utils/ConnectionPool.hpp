@@ -1,37 +1,369 @@
 #ifndef CONNECTIONPOOL_HPP
 #define CONNECTIONPOOL_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <pqxx/pqxx>
-#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct ConnectionPoolOptions {
+    // Connections opened at startup and never reaped
+    size_t minSize = 4;
+    // Upper bound the pool grows to while every connection is leased
+    size_t maxSize = 16;
+    // Connections above minSize idle for longer than this are closed
+    // (0 = never)
+    std::chrono::milliseconds idleTimeout{60000};
+    // How long acquire() waits for a free connection before giving up
+    std::chrono::milliseconds acquireTimeout{2000};
+    // A connection idle for longer than this is checked with a round trip
+    // before being handed out (0 = check on every checkout)
+    std::chrono::milliseconds validateAfterIdle{30000};
+    // Runs on every new connection before its first use, reconnects
+    // included: per-session setup such as preparing statements
+    std::function<void(pqxx::connection&)> onConnect;
+};
+
+// Thrown by acquire() when no connection could be handed out: none was
+// released in time, or a broken one could not be reconnected. Callers
+// should answer "try again later", the pool itself stays usable.
+class PoolUnavailable : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
 
 class ConnectionPool {
    public:
-    ConnectionPool(const std::string& connInfo, size_t size) {
-        for (size_t i = 0; i < size; i++) {
-            pool.push(std::make_unique<pqxx::connection>(connInfo));
+    // Move-only handle on a checked out connection: gives it back to the
+    // pool when destroyed, so a handler that throws cannot leak it.
+    class Lease {
+       public:
+        Lease(Lease&& other) noexcept
+            : pool(std::exchange(other.pool, nullptr)),
+              conn(std::move(other.conn)) {}
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                pool = std::exchange(other.pool, nullptr);
+                conn = std::move(other.conn);
+            }
+            return *this;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { reset(); }
+
+        pqxx::connection& operator*() const { return *conn; }
+        pqxx::connection* operator->() const { return conn.get(); }
+
+        // Give the connection back before the lease goes out of scope
+        void reset() {
+            if (pool != nullptr && conn) {
+                pool->release(std::move(conn));
+            }
+            pool = nullptr;
+        }
+
+       private:
+        friend class ConnectionPool;
+
+        Lease(ConnectionPool* pool_param,
+              std::unique_ptr<pqxx::connection> conn_param)
+            : pool(pool_param), conn(std::move(conn_param)) {}
+
+        ConnectionPool* pool;
+        std::unique_ptr<pqxx::connection> conn;
+    };
+
+    struct Stats {
+        // Open connections, leased or idle
+        std::size_t size = 0;
+        std::size_t maxSize = 0;
+        std::size_t idle = 0;
+        std::uint64_t acquired = 0;
+        std::uint64_t timeouts = 0;
+        // Total time callers spent waiting in acquire()
+        std::uint64_t waitMicroseconds = 0;
+        std::uint64_t reconnects = 0;
+        std::uint64_t reconnectFailures = 0;
+        // Connections opened past minSize under contention, and closed
+        // again after idleTimeout
+        std::uint64_t grown = 0;
+        std::uint64_t reaped = 0;
+    };
+
+    // Opens options.minSize connections in parallel
+    // throws: std::invalid_argument on inconsistent sizes, or the
+    //         connection error if the database is unreachable
+    explicit ConnectionPool(const std::string& connInfo_param,
+                            ConnectionPoolOptions options_param = {})
+        : connInfo(connInfo_param), options(options_param) {
+        if (options.maxSize == 0 || options.minSize > options.maxSize) {
+            throw std::invalid_argument(
+                "Invalid pool size: min " + std::to_string(options.minSize) +
+                ", max " + std::to_string(options.maxSize) +
+                ". Max must be greater than 0 and not less than min");
+        }
+        // Connecting is mostly waiting on round trips (TCP, TLS, auth), so
+        // a large minSize starts in the time of one connection
+        std::vector<std::future<std::unique_ptr<pqxx::connection>>> opening;
+        for (size_t i = 0; i < options.minSize; i++) {
+            opening.push_back(
+                std::async(std::launch::async, [this] { return connect(); }));
+        }
+        for (auto& connection : opening) {
+            idle.push_back({connection.get(), Clock::now()});
+        }
+        total = idle.size();
+        if (options.idleTimeout.count() > 0 &&
+            options.maxSize > options.minSize) {
+            reaper = std::thread([this] { reapIdleConnections(); });
         }
     }
-    std::unique_ptr<pqxx::connection> acquire() {
-        std::unique_lock<std::mutex> lock(mtx);
-        cv.wait(lock, [this] { return !pool.empty(); });
 
-        auto conn = std::move(pool.front());
-        pool.pop();
-        return conn;
+    ~ConnectionPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        reaperCv.notify_one();
+        if (reaper.joinable()) {
+            reaper.join();
+        }
     }
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Waits up to options.acquireTimeout
+    Lease acquire() { return acquire(options.acquireTimeout); }
+
+    // Hands out an idle connection, or opens a new one while the pool is
+    // below maxSize. One that was dropped by the server is replaced by a
+    // new one first.
+    // throws: PoolUnavailable on timeout or when connecting fails
+    Lease acquire(std::chrono::milliseconds timeout) {
+        auto start = Clock::now();
+        Slot slot;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            bool available = cv.wait_for(lock, timeout, [this] {
+                return !idle.empty() || total < options.maxSize;
+            });
+            waitMicroseconds.fetch_add(elapsedMicroseconds(start),
+                                       std::memory_order_relaxed);
+            if (!available) {
+                timeouts.fetch_add(1, std::memory_order_relaxed);
+                throw PoolUnavailable(
+                    "Timed out after " + std::to_string(timeout.count()) +
+                    " ms waiting for a database connection");
+            }
+            takeSlot(slot);
+        }
+        return checkOut(std::move(slot));
+    }
+
+    // Like acquire(), but returns std::nullopt at once instead of waiting
+    // when every connection is leased and the pool is at maxSize. For
+    // callers that must not block their thread (AsyncPostgresDB).
+    // throws: PoolUnavailable when connecting fails
+    std::optional<Lease> tryAcquire() {
+        Slot slot;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (idle.empty() && total >= options.maxSize) {
+                return std::nullopt;
+            }
+            takeSlot(slot);
+        }
+        return checkOut(std::move(slot));
+    }
+
+    // Longest wait acquire() allows, for callers retrying tryAcquire()
+    std::chrono::milliseconds acquireTimeout() const {
+        return options.acquireTimeout;
+    }
+
+    Stats stats() const {
+        Stats result;
+        result.maxSize = options.maxSize;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            result.size = total;
+            result.idle = idle.size();
+        }
+        result.acquired = acquired.load(std::memory_order_relaxed);
+        result.timeouts = timeouts.load(std::memory_order_relaxed);
+        result.waitMicroseconds =
+            waitMicroseconds.load(std::memory_order_relaxed);
+        result.reconnects = reconnects.load(std::memory_order_relaxed);
+        result.reconnectFailures =
+            reconnectFailures.load(std::memory_order_relaxed);
+        result.grown = grown.load(std::memory_order_relaxed);
+        result.reaped = reaped.load(std::memory_order_relaxed);
+        return result;
+    }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        // nullptr for a connection that still has to be opened
+        std::unique_ptr<pqxx::connection> conn;
+        Clock::time_point idleSince;
+    };
+
+    std::string connInfo;
+    ConnectionPoolOptions options;
+    // Oldest idle connection at the front
+    std::deque<Slot> idle;
+    // Connections open or being opened, leased ones included
+    size_t total = 0;
+    bool stopping = false;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::condition_variable reaperCv;
+
+    std::atomic<std::uint64_t> acquired{0};
+    std::atomic<std::uint64_t> timeouts{0};
+    std::atomic<std::uint64_t> waitMicroseconds{0};
+    std::atomic<std::uint64_t> reconnects{0};
+    std::atomic<std::uint64_t> reconnectFailures{0};
+    std::atomic<std::uint64_t> grown{0};
+    std::atomic<std::uint64_t> reaped{0};
+
+    // Started last, once everything it reads is initialized
+    std::thread reaper;
+
+    // Takes the slot a checkout uses, with mtx held and a connection known
+    // to be available
+    void takeSlot(Slot& slot) {
+        if (!idle.empty()) {
+            // Most recently used first: it is the least likely to be
+            // stale, and the others age at the front for the reaper
+            slot = std::move(idle.back());
+            idle.pop_back();
+        } else {
+            // Reserve the new connection's place before unlocking
+            total++;
+            grown.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Outside the lock: the check and connecting are round trips
+    Lease checkOut(Slot slot) {
+        acquired.fetch_add(1, std::memory_order_relaxed);
+        if (!isHealthy(slot)) {
+            reconnect(slot);
+        }
+        return Lease(this, std::move(slot.conn));
+    }
+
     void release(std::unique_ptr<pqxx::connection> conn) {
         std::lock_guard<std::mutex> lock(mtx);
-        pool.push(std::move(conn));
+        idle.push_back({std::move(conn), Clock::now()});
         cv.notify_one();
     }
 
-   private:
-    std::queue<std::unique_ptr<pqxx::connection>> pool;
-    std::mutex mtx;
-    std::condition_variable cv;
+    // is_open() only notices a drop after a failed query, so a connection
+    // that sat idle long enough to have been cut is pinged as well
+    bool isHealthy(const Slot& slot) const {
+        if (!slot.conn || !slot.conn->is_open()) {
+            return false;
+        }
+        if (Clock::now() - slot.idleSince < options.validateAfterIdle) {
+            return true;
+        }
+        try {
+            pqxx::nontransaction ping(*slot.conn);
+            ping.exec("SELECT 1");
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    std::unique_ptr<pqxx::connection> connect() const {
+        auto conn = std::make_unique<pqxx::connection>(connInfo);
+        if (options.onConnect) {
+            options.onConnect(*conn);
+        }
+        return conn;
+    }
+
+    // Opens the slot's connection, replacing a broken one
+    void reconnect(Slot& slot) {
+        bool replacing = slot.conn != nullptr;
+        slot.conn.reset();
+        try {
+            slot.conn = connect();
+            if (replacing) {
+                reconnects.fetch_add(1, std::memory_order_relaxed);
+            }
+        } catch (const std::exception& e) {
+            reconnectFailures.fetch_add(1, std::memory_order_relaxed);
+            // Give the place back: a later checkout opens a new connection
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                total--;
+            }
+            cv.notify_one();
+            throw PoolUnavailable(
+                std::string("Could not connect to the database: ") +
+                e.what());
+        }
+    }
+
+    // Reaper thread: closes connections idle for longer than idleTimeout,
+    // oldest first, without going below minSize
+    void reapIdleConnections() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!stopping) {
+            reaperCv.wait_for(lock, reapInterval(),
+                              [this] { return stopping; });
+            std::vector<std::unique_ptr<pqxx::connection>> expired;
+            auto deadline = Clock::now() - options.idleTimeout;
+            while (!idle.empty() && total > options.minSize &&
+                   idle.front().idleSince <= deadline) {
+                expired.push_back(std::move(idle.front().conn));
+                idle.pop_front();
+                total--;
+            }
+            if (!expired.empty()) {
+                reaped.fetch_add(expired.size(), std::memory_order_relaxed);
+                // Closing is a round trip, do not hold up acquire()
+                lock.unlock();
+                expired.clear();
+                lock.lock();
+            }
+        }
+    }
+
+    // Twice per idleTimeout: a connection is closed at most 1.5 timeouts
+    // after its last use
+    std::chrono::milliseconds reapInterval() const {
+        return std::max(options.idleTimeout / 2, std::chrono::milliseconds(1));
+    }
+
+    static std::uint64_t elapsedMicroseconds(Clock::time_point start) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - start)
+                .count());
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
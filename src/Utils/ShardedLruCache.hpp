@@ -0,0 +1,252 @@
+#ifndef SHARDEDLRUCACHE_HPP
+#define SHARDEDLRUCACHE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/*
+ * ShardedLruCache.hpp
+ *
+ * Thread-safe LRU cache with a time to live. Keys are spread over
+ * independent shards by hash, each with its own mutex, list and map, so
+ * threads reading different keys rarely wait for one another. A shard
+ * evicts its least recently used entry when it is full.
+ *
+ * Read-through without stale entries: a reader that misses takes the
+ * shard's epoch() before loading the value and stores it with
+ * putIfUnchanged(). Every erase() bumps the epoch, so a value loaded
+ * before an invalidation that raced with it is dropped instead of cached.
+ *
+ * A source that lags behind the writes (a read replica) can still return
+ * the erased version after the erase. With a settle time, erase() also
+ * remembers when it dropped each key, and a value stored as lagging is
+ * refused while its key was erased less than settle ago. Keys not written
+ * recently are cached from such a source as from any other.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+   public:
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        // Entries dropped to make room
+        std::uint64_t evictions = 0;
+        // Entries found past their TTL
+        std::uint64_t expirations = 0;
+        // Entries dropped by erase()
+        std::uint64_t invalidations = 0;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+    };
+
+    // capacity: entries held at most, split evenly over the shards
+    // ttl: age after which an entry is a miss (0 = never expires)
+    // settle: how long after erase() lagging stores of the key are refused
+    //         (0 = never)
+    // throws: std::invalid_argument on a zero capacity or shard count, or
+    //         a negative ttl or settle
+    ShardedLruCache(std::size_t capacity, std::chrono::milliseconds ttl_param,
+                    std::size_t shardCount = 16,
+                    std::chrono::milliseconds settle_param =
+                        std::chrono::milliseconds(0))
+        : ttl(ttl_param), settle(settle_param) {
+        if (capacity == 0 || shardCount == 0 || ttl.count() < 0 ||
+            settle.count() < 0) {
+            throw std::invalid_argument(
+                "Invalid cache settings: capacity " +
+                std::to_string(capacity) + ", shards " +
+                std::to_string(shardCount) + ", ttl " +
+                std::to_string(ttl.count()) + " ms, settle " +
+                std::to_string(settle.count()) +
+                " ms. Capacity and shards must be greater than 0, ttl and "
+                "settle must not be negative");
+        }
+        // Fewer shards than entries would leave some of them empty
+        shardCount = std::min(shardCount, capacity);
+        shards = std::make_unique<Shard[]>(shardCount);
+        shardTotal = shardCount;
+        shardCapacity = (capacity + shardCount - 1) / shardCount;
+    }
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    // Copies the value of key into out and marks it most recently used.
+    // return: false on a miss (absent or expired); out is left untouched
+    bool get(const Key& key, Value& out) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto found = shard.index.find(key);
+        if (found == shard.index.end()) {
+            shard.misses++;
+            return false;
+        }
+        auto entry = found->second;
+        if (ttl.count() > 0 && Clock::now() >= entry->expiresAt) {
+            shard.index.erase(found);
+            shard.entries.erase(entry);
+            shard.expirations++;
+            shard.misses++;
+            return false;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+        shard.hits++;
+        out = entry->value;
+        return true;
+    }
+
+    // Current epoch of key's shard, to pass to putIfUnchanged()
+    std::uint64_t epoch(const Key& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        return shard.epoch;
+    }
+
+    // Stores value unless an erase() hit key's shard since epoch was read,
+    // or, for a lagging value, key was erased less than settle ago.
+    // return: whether it was stored
+    bool putIfUnchanged(const Key& key, Value value, std::uint64_t epoch,
+                        bool lagging = false) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        if (shard.epoch != epoch) {
+            return false;
+        }
+        if (lagging && settle.count() > 0) {
+            auto erased = shard.erasedAt.find(key);
+            if (erased != shard.erasedAt.end() &&
+                Clock::now() - erased->second < settle) {
+                return false;
+            }
+        }
+        store(shard, key, std::move(value));
+        return true;
+    }
+
+    // Stores value unconditionally
+    void put(const Key& key, Value value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        store(shard, key, std::move(value));
+    }
+
+    // Drops key, and makes loads of its shard that started earlier fail
+    // their putIfUnchanged(), as well as lagging ones of key for settle
+    void erase(const Key& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.epoch++;
+        if (settle.count() > 0) {
+            rememberErase(shard, key);
+        }
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            shard.entries.erase(found->second);
+            shard.index.erase(found);
+            shard.invalidations++;
+        }
+    }
+
+    // Sums the shards' counters, each read under its own lock
+    Stats stats() const {
+        Stats result;
+        result.capacity = shardCapacity * shardTotal;
+        for (std::size_t i = 0; i < shardTotal; i++) {
+            const Shard& shard = shards[i];
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            result.hits += shard.hits;
+            result.misses += shard.misses;
+            result.evictions += shard.evictions;
+            result.expirations += shard.expirations;
+            result.invalidations += shard.invalidations;
+            result.size += shard.entries.size();
+        }
+        return result;
+    }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Key key;
+        Value value;
+        Clock::time_point expiresAt;
+    };
+
+    struct Shard {
+        mutable std::mutex mtx;
+        // Most recently used at the front
+        std::list<Entry> entries;
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash>
+            index;
+        std::uint64_t epoch = 0;
+        // Key -> time of its last erase(), kept for settle; expired ones
+        // are pruned at most once per settle
+        std::unordered_map<Key, Clock::time_point, Hash> erasedAt;
+        Clock::time_point nextPrune;
+        // Counted under mtx, which is held anyway: no shared atomics
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t expirations = 0;
+        std::uint64_t invalidations = 0;
+    };
+
+    std::chrono::milliseconds ttl;
+    std::chrono::milliseconds settle;
+    std::unique_ptr<Shard[]> shards;
+    std::size_t shardTotal = 0;
+    std::size_t shardCapacity = 0;
+    Hash hash;
+
+    Shard& shardFor(const Key& key) { return shards[hash(key) % shardTotal]; }
+
+    // With shard.mtx held
+    void rememberErase(Shard& shard, const Key& key) {
+        auto now = Clock::now();
+        shard.erasedAt.insert_or_assign(key, now);
+        if (now < shard.nextPrune) {
+            return;
+        }
+        for (auto entry = shard.erasedAt.begin();
+             entry != shard.erasedAt.end();) {
+            if (now - entry->second >= settle) {
+                entry = shard.erasedAt.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+        shard.nextPrune = now + settle;
+    }
+
+    // With shard.mtx held
+    void store(Shard& shard, const Key& key, Value value) {
+        auto expiresAt = Clock::now() + ttl;
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            found->second->value = std::move(value);
+            found->second->expiresAt = expiresAt;
+            shard.entries.splice(shard.entries.begin(), shard.entries,
+                                 found->second);
+            return;
+        }
+        if (shard.entries.size() >= shardCapacity) {
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+            shard.evictions++;
+        }
+        shard.entries.push_front({key, std::move(value), expiresAt});
+        shard.index.emplace(key, shard.entries.begin());
+    }
+};
+
+#endif
@@ -11,7 +11,8 @@
 
 // Fixed-size thread pool for concurrent task execution.
 // Spawns worker threads that dequeue tasks from a blocking queue
-// and execute them. Supports graceful shutdown via queue.stop().
+// and execute them. The queue can be bounded (admission control: see
+// tryEnqueueTask). Supports graceful shutdown via queue.stop().
 class ThreadPool {
    private:
     int workersCount;
@@ -41,7 +42,10 @@ class ThreadPool {
     }
 
    public:
-    explicit ThreadPool(int workersCount) : workersCount(workersCount) {
+    // queueCapacity: tasks allowed to wait for a worker through
+    // tryEnqueueTask(), 0 = unbounded
+    explicit ThreadPool(int workersCount, std::size_t queueCapacity = 0)
+        : workersCount(workersCount), clientsQueue(queueCapacity) {
         for (int i = 0; i < workersCount; i++) {
             workers.emplace_back([this]() { this->workerLoop(); });
         }
@@ -64,6 +68,23 @@ class ThreadPool {
             std::forward<TaskType>(task));
         clientsQueue.push(std::move(taskPtr));
     }
+
+    // Enqueues task unless queueCapacity tasks are already waiting. On
+    // failure task is left untouched, so the caller can still reject it
+    // (load shedding) instead of letting latency grow without bound.
+    template <typename TaskType>
+    bool tryEnqueueTask(std::unique_ptr<TaskType>& task) {
+        std::unique_ptr<Task> taskPtr = std::move(task);
+        if (clientsQueue.tryPush(taskPtr)) {
+            return true;
+        }
+        task.reset(static_cast<TaskType*>(taskPtr.release()));
+        return false;
+    }
+
+    // Tasks waiting for a worker
+    std::size_t queuedTasks() const { return clientsQueue.size(); }
+    std::size_t queueCapacity() const { return clientsQueue.maxSize(); }
 };
 
 #endif
\ No newline at end of file
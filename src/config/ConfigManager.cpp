@@ -166,6 +166,15 @@ int ConfigManager::getInt(const std::string& key) const {
     }
 }
 
+std::string ConfigManager::get(const std::string& key,
+                               const std::string& defaultValue) const {
+    return has(key) ? get(key) : defaultValue;
+}
+
+int ConfigManager::getInt(const std::string& key, int defaultValue) const {
+    return has(key) ? getInt(key) : defaultValue;
+}
+
 bool ConfigManager::has(const std::string& key) const {
     /*
      * Check if key exists without throwing
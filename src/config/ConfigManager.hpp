@@ -36,6 +36,17 @@ class ConfigManager {
      */
     int getInt(const std::string& key) const;
 
+    /**
+     * Retrieve an optional configuration value
+     *
+     * Same as get()/getInt() but returns defaultValue when the key is absent.
+     * Used for tuning knobs (thread counts, timeouts) that have sane defaults.
+     * throws: std::runtime_error if the key exists but is not a valid integer
+     */
+    std::string get(const std::string& key,
+                    const std::string& defaultValue) const;
+    int getInt(const std::string& key, int defaultValue) const;
+
     /**
      * Check if a key exists in configuration
      *
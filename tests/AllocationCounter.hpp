@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+// Heap allocations made by the calling thread so far. The test binary
+// replaces the global operator new (AllocationCounter.cpp) to count them, so
+// a test can check that a hot path does not allocate:
+//   auto before = allocationsOnThisThread();
+//   ...
+//   EXPECT_EQ(allocationsOnThisThread() - before, 0u);
+std::size_t allocationsOnThisThread();
+
+#endif
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "../src/DataBase/AsyncPostgresDB.hpp"
+#include "../src/DataBase/PostgresDB.hpp"
+#include "../src/config/ConfigManager.hpp"
+
+namespace asio = boost::asio;
+
+static Reservation createBaseReservation(int room) {
+    Reservation res;
+    res.guest_name = "TESTING_OWNER";
+    res.guest_email = "async@example.com";
+    res.guest_phone = "+34612345678";
+    res.room_number = room;
+    res.room_type = "Doble";
+    res.number_of_guests = 2;
+    res.check_in_date = "2026-02-15";
+    res.check_out_date = "2026-02-18";
+    res.number_of_nights = 3;
+    res.price_per_night = 150.0;
+    res.total_price = 450.0;
+    res.payment_method = "credit_card";
+    res.paid = true;
+    res.reservation_status = "confirmed";
+    res.special_requests = "Test";
+    res.created_at = 1707427200;
+    res.updated_at = 1707427200;
+    return res;
+}
+
+static void cleanupTestData() {
+    try {
+        ConfigManager config(".env");
+        std::ostringstream oss;
+        oss << "host=" << config.get("DB_HOST")
+            << " port=" << config.getInt("DB_PORT")
+            << " dbname=" << config.get("DB_NAME")
+            << " user=" << config.get("DB_USER")
+            << " password=" << config.get("DB_PASSWORD");
+
+        pqxx::connection conn(oss.str());
+        pqxx::work txn(conn);
+        txn.exec("DELETE FROM reservations WHERE guest_name='TESTING_OWNER'");
+        txn.commit();
+    } catch (const std::exception& e) {
+        std::cerr << "Cleanup failed: " << e.what() << "\n";
+    }
+}
+
+// Insert, read, update and delete one reservation; false at the first
+// step that does not give the expected answer
+static asio::awaitable<bool> roundTrip(AsyncPostgresDB& db, int room) {
+    int id = co_await db.insertReservation(createBaseReservation(room));
+    if (id == -1) {
+        co_return false;
+    }
+    Reservation res = co_await db.getReservationById(id);
+    if (res.room_number != room) {
+        co_return false;
+    }
+    res.special_requests = "Updated";
+    if (!co_await db.updateReservation(id, res)) {
+        co_return false;
+    }
+    res = co_await db.getReservationById(id);
+    if (res.special_requests != "Updated") {
+        co_return false;
+    }
+    co_return co_await db.deleteReservation(id);
+}
+
+// Many coroutines on a single thread each run their operations with a
+// statement in flight at the same time
+TEST(AsyncPostgresDB, ConcurrentOperationsOnOneThread) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    asio::io_context ioc;
+    AsyncPostgresDB async(db, ioc.get_executor());
+
+    constexpr int kCoroutines = 24;
+    std::vector<int> passed(kCoroutines, -1);
+    for (int i = 0; i < kCoroutines; i++) {
+        asio::co_spawn(ioc, roundTrip(async, 200 + i),
+                       [&passed, i](std::exception_ptr error, bool ok) {
+                           passed[i] = !error && ok ? 1 : 0;
+                       });
+    }
+    ioc.run();
+
+    for (int i = 0; i < kCoroutines; i++) {
+        EXPECT_EQ(passed[i], 1) << "Coroutine " << i << " failed";
+    }
+    cleanupTestData();
+}
+
+// The completion token forms work outside coroutines, e.g. with futures,
+// and report the same outcomes as PostgresDB
+TEST(AsyncPostgresDB, CompletionTokens) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    asio::io_context ioc;
+    auto work = asio::make_work_guard(ioc);
+    std::thread ioThread([&ioc] { ioc.run(); });
+    AsyncPostgresDB async(db, ioc.get_executor());
+
+    int id = async.asyncInsertReservation(createBaseReservation(230),
+                                          asio::use_future)
+                 .get();
+    ASSERT_NE(id, -1);
+    EXPECT_EQ(async.asyncInsertReservation(createBaseReservation(230),
+                                           asio::use_future)
+                  .get(),
+              -1)
+        << "An overlapping stay should be rejected";
+    EXPECT_EQ(async.asyncGetReservationById(id, asio::use_future)
+                  .get()
+                  .room_number,
+              230);
+    EXPECT_FALSE(
+        async.asyncDeleteReservation(999999, asio::use_future).get());
+    EXPECT_TRUE(async.asyncDeleteReservation(id, asio::use_future).get());
+    EXPECT_THROW(async.asyncGetReservationById(id, asio::use_future).get(),
+                 ReservationNotFound);
+
+    work.reset();
+    ioThread.join();
+    cleanupTestData();
+}
+
+// Waiting for a connection of an exhausted pool does not block the io
+// thread, and ends in PoolUnavailable after the acquire timeout
+TEST(AsyncPostgresDB, WaitsForConnectionWithoutBlocking) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ConnectionPool* pool = db.getConnectionPool();
+    std::vector<ConnectionPool::Lease> held;
+    while (auto lease = pool->tryAcquire()) {
+        held.push_back(std::move(*lease));
+    }
+
+    asio::io_context ioc;
+    AsyncPostgresDB async(db, ioc.get_executor());
+    bool finished = false;
+    std::exception_ptr error;
+    async.asyncGetReservationById(1, [&](std::exception_ptr e, Reservation) {
+        error = e;
+        finished = true;
+    });
+    // Keeps running on the same thread while the lookup waits
+    int ticks = 0;
+    asio::steady_timer ticker(ioc);
+    std::function<void(boost::system::error_code)> tick =
+        [&](boost::system::error_code) {
+            if (finished) {
+                return;
+            }
+            ticks++;
+            ticker.expires_after(std::chrono::milliseconds(10));
+            ticker.async_wait(tick);
+        };
+    tick({});
+    ioc.run();
+
+    ASSERT_TRUE(error);
+    EXPECT_THROW(std::rethrow_exception(error), PoolUnavailable);
+    EXPECT_GT(ticks, 10);
+}
@@ -769,3 +769,176 @@ TEST(ClientConnection, InvalidEndpoint) {
     server.stop();
     std::this_thread::sleep_for(std::chrono::milliseconds(1500));
 }
+
+// Starts a server in a detached thread and waits until it is listening
+static void startServerInBackground(HttpServer& server) {
+    std::barrier sync_point(2);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[ClientConnectionTest] Server error: " << e.what()
+                      << "\n";
+        }
+    });
+    server_thread.detach();
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+}
+
+static std::string rawGet(const std::string& target) {
+    return "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+}
+
+// Test keep-alive - several requests are served on one TCP connection
+TEST(ClientConnection, KeepAliveServesSeveralRequests) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    HttpServer server(&db, 8812);
+    startServerInBackground(server);
+
+    boost::asio::io_context ioc;
+    beast::tcp_stream stream(ioc);
+    stream.expires_after(std::chrono::seconds(5));
+    stream.connect(
+        tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8812));
+    beast::flat_buffer buffer;
+    for (int i = 0; i < 3; i++) {
+        boost::asio::write(stream, boost::asio::buffer(rawGet("/invalid")));
+        http::response<http::string_body> response;
+        http::read(stream, buffer, response);
+        EXPECT_EQ(response.result(), http::status::not_found);
+        EXPECT_TRUE(response.keep_alive());
+    }
+    stream.socket().close();
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+// Test pipelining - requests sent back to back are answered in order
+TEST(ClientConnection, PipelinedRequestsAnsweredInOrder) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    HttpServer server(&db, 8813);
+    startServerInBackground(server);
+
+    boost::asio::io_context ioc;
+    beast::tcp_stream stream(ioc);
+    stream.expires_after(std::chrono::seconds(5));
+    stream.connect(
+        tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8813));
+    // Non numeric id -> 400, unknown endpoint -> 404
+    std::string pipelined = rawGet("/application/reservation/abc") +
+                            rawGet("/invalid") +
+                            rawGet("/application/reservation/abc");
+    boost::asio::write(stream, boost::asio::buffer(pipelined));
+
+    beast::flat_buffer buffer;
+    const http::status expected[] = {http::status::bad_request,
+                                     http::status::not_found,
+                                     http::status::bad_request};
+    for (http::status status : expected) {
+        http::response<http::string_body> response;
+        http::read(stream, buffer, response);
+        EXPECT_EQ(response.result(), status);
+    }
+    stream.socket().close();
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+// Test request limit - the last allowed response closes the connection
+TEST(ClientConnection, MaxRequestsPerConnection) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.maxRequestsPerConnection = 2;
+    HttpServer server(&db, 8814, options);
+    startServerInBackground(server);
+
+    boost::asio::io_context ioc;
+    beast::tcp_stream stream(ioc);
+    stream.expires_after(std::chrono::seconds(5));
+    stream.connect(
+        tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8814));
+    beast::flat_buffer buffer;
+    for (int i = 0; i < 2; i++) {
+        boost::asio::write(stream, boost::asio::buffer(rawGet("/invalid")));
+        http::response<http::string_body> response;
+        http::read(stream, buffer, response);
+        EXPECT_EQ(response.keep_alive(), i == 0);
+    }
+    // The server closed its side after the second response
+    http::response<http::string_body> response;
+    beast::error_code ec;
+    http::read(stream, buffer, response, ec);
+    EXPECT_EQ(ec, http::error::end_of_stream);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+// Test idle timeout - an idle keep-alive connection is closed by the server
+TEST(ClientConnection, KeepAliveIdleTimeout) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.keepAliveTimeoutMs = 200;
+    HttpServer server(&db, 8815, options);
+    startServerInBackground(server);
+
+    boost::asio::io_context ioc;
+    beast::tcp_stream stream(ioc);
+    stream.expires_after(std::chrono::seconds(5));
+    stream.connect(
+        tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8815));
+    beast::flat_buffer buffer;
+    boost::asio::write(stream, boost::asio::buffer(rawGet("/invalid")));
+    http::response<http::string_body> response;
+    http::read(stream, buffer, response);
+    EXPECT_TRUE(response.keep_alive());
+
+    // Send nothing: the server gives up after the idle timeout
+    http::response<http::string_body> next;
+    beast::error_code ec;
+    http::read(stream, buffer, next, ec);
+    EXPECT_EQ(ec, http::error::end_of_stream);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+// Test body deadline - a client that stops sending half way through the body
+// is disconnected instead of holding the worker
+TEST(ClientConnection, BodyTimeoutClosesSlowUpload) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.bodyTimeoutMs = 200;
+    HttpServer server(&db, 8820, options);
+    startServerInBackground(server);
+
+    boost::asio::io_context ioc;
+    beast::tcp_stream stream(ioc);
+    stream.expires_after(std::chrono::seconds(5));
+    stream.connect(
+        tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 8820));
+    std::string partial =
+        "POST /application/reservation HTTP/1.1\r\nHost: localhost\r\n"
+        "Content-Type: application/json\r\nContent-Length: 50\r\n\r\n"
+        "{\"guest_name\"";
+    boost::asio::write(stream, boost::asio::buffer(partial));
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> response;
+    beast::error_code ec;
+    http::read(stream, buffer, response, ec);
+    EXPECT_EQ(ec, http::error::end_of_stream);
+    EXPECT_EQ(server.metrics().timedOutConnections.load(), 1u);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
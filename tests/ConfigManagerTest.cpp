@@ -306,3 +306,30 @@ DB_PASSWORD=testpass
 
     deleteTestEnvFile(".env.test");
 }
+
+TEST(ConfigManager, GetWithDefaultValue) {
+    std::string testEnvContent = R"(
+DB_HOST=127.0.0.1
+DB_PORT=5432
+DB_NAME=test_db
+DB_USER=testuser
+DB_PASSWORD=testpass
+SERVER_IO_THREADS=6
+)";
+
+    createTestEnvFile(".env.test", testEnvContent);
+
+    try {
+        ConfigManager config(".env.test");
+        EXPECT_EQ(config.getInt("SERVER_IO_THREADS", 1), 6);
+        EXPECT_EQ(config.getInt("NONEXISTENT_KEY", 42), 42);
+        EXPECT_EQ(config.get("DB_HOST", "localhost"), "127.0.0.1");
+        EXPECT_EQ(config.get("NONEXISTENT_KEY", "fallback"), "fallback");
+        EXPECT_THROW(config.getInt("DB_HOST", 1), std::runtime_error);
+    } catch (...) {
+        deleteTestEnvFile(".env.test");
+        throw;
+    }
+
+    deleteTestEnvFile(".env.test");
+}
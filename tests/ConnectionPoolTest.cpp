@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "../src/Utils/ConnectionPool.hpp"
+#include "../src/config/ConfigManager.hpp"
+
+static std::string connectionString() {
+    ConfigManager config(".env");
+    std::ostringstream oss;
+    oss << "host=" << config.get("DB_HOST")
+        << " port=" << config.getInt("DB_PORT")
+        << " dbname=" << config.get("DB_NAME")
+        << " user=" << config.get("DB_USER")
+        << " password=" << config.get("DB_PASSWORD");
+    return oss.str();
+}
+
+static ConnectionPoolOptions sizedOptions(size_t minSize, size_t maxSize) {
+    ConnectionPoolOptions options;
+    options.minSize = minSize;
+    options.maxSize = maxSize;
+    return options;
+}
+
+// A lease gives its connection back when destroyed, even by an exception
+TEST(ConnectionPool, LeaseReturnsConnectionOnScopeExit) {
+    ConnectionPool pool(connectionString(), sizedOptions(1, 1));
+    EXPECT_EQ(pool.stats().idle, 1u);
+    try {
+        auto conn = pool.acquire();
+        EXPECT_EQ(pool.stats().idle, 0u);
+        throw std::runtime_error("handler failed");
+    } catch (const std::runtime_error&) {
+    }
+    EXPECT_EQ(pool.stats().idle, 1u);
+
+    auto first = pool.acquire();
+    auto moved = std::move(first);
+    EXPECT_EQ(pool.stats().idle, 0u);
+    moved.reset();
+    EXPECT_EQ(pool.stats().idle, 1u);
+    EXPECT_EQ(pool.stats().acquired, 2u);
+}
+
+// acquire() fails fast instead of waiting forever on an exhausted pool
+TEST(ConnectionPool, AcquireTimesOut) {
+    ConnectionPool pool(connectionString(), sizedOptions(1, 1));
+    auto held = pool.acquire();
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_THROW(pool.acquire(std::chrono::milliseconds(50)),
+                 PoolUnavailable);
+    auto waited = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(waited, std::chrono::milliseconds(50));
+    EXPECT_LT(waited, std::chrono::seconds(2));
+
+    ConnectionPool::Stats stats = pool.stats();
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_GE(stats.waitMicroseconds, 50000u);
+}
+
+// tryAcquire() grows the pool like acquire(), but gives up at once when
+// it is full instead of waiting or counting a timeout
+TEST(ConnectionPool, TryAcquireDoesNotWait) {
+    ConnectionPool pool(connectionString(), sizedOptions(0, 1));
+    auto held = pool.tryAcquire();
+    ASSERT_TRUE(held.has_value());
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(pool.tryAcquire().has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(50));
+    EXPECT_EQ(pool.stats().timeouts, 0u);
+
+    held.reset();
+    EXPECT_TRUE(pool.tryAcquire().has_value());
+}
+
+// A connection closed while leased is replaced at the next checkout
+TEST(ConnectionPool, ReconnectsClosedConnection) {
+    ConnectionPool pool(connectionString(), sizedOptions(1, 1));
+    {
+        auto conn = pool.acquire();
+        conn->close();
+    }
+    auto conn = pool.acquire();
+    EXPECT_TRUE(conn->is_open());
+    pqxx::nontransaction txn(*conn);
+    EXPECT_EQ(txn.exec("SELECT 1")[0][0].as<int>(), 1);
+    EXPECT_EQ(pool.stats().reconnects, 1u);
+}
+
+// A connection the server dropped while idle is detected by the checkout
+// ping and replaced, like after a database failover
+TEST(ConnectionPool, ReplacesConnectionDroppedByServer) {
+    ConnectionPoolOptions options = sizedOptions(1, 1);
+    options.validateAfterIdle = std::chrono::milliseconds(0);
+    ConnectionPool pool(connectionString(), options);
+    int backendPid = 0;
+    {
+        auto conn = pool.acquire();
+        backendPid = conn->backendpid();
+    }
+
+    pqxx::connection admin(connectionString());
+    pqxx::nontransaction kill(admin);
+    kill.exec("SELECT pg_terminate_backend(" + std::to_string(backendPid) +
+              ")");
+
+    auto conn = pool.acquire();
+    EXPECT_NE(conn->backendpid(), backendPid);
+    pqxx::nontransaction txn(*conn);
+    EXPECT_EQ(txn.exec("SELECT 1")[0][0].as<int>(), 1);
+    EXPECT_EQ(pool.stats().reconnects, 1u);
+}
+
+TEST(ConnectionPool, RejectsInvalidSizes) {
+    EXPECT_THROW(ConnectionPool("", sizedOptions(0, 0)), std::invalid_argument);
+    EXPECT_THROW(ConnectionPool("", sizedOptions(4, 2)), std::invalid_argument);
+}
+
+// Starts with min connections, opens more only while all are leased and
+// stops at max
+TEST(ConnectionPool, GrowsUpToMaxUnderContention) {
+    ConnectionPool pool(connectionString(), sizedOptions(1, 3));
+    EXPECT_EQ(pool.stats().size, 1u);
+
+    auto first = pool.acquire();
+    auto second = pool.acquire();
+    auto third = pool.acquire();
+    ConnectionPool::Stats stats = pool.stats();
+    EXPECT_EQ(stats.size, 3u);
+    EXPECT_EQ(stats.grown, 2u);
+    EXPECT_THROW(pool.acquire(std::chrono::milliseconds(20)),
+                 PoolUnavailable);
+
+    // Released connections are reused rather than opening new ones
+    second.reset();
+    auto again = pool.acquire();
+    EXPECT_EQ(pool.stats().grown, 2u);
+}
+
+// Connections above min are closed once idle for idleTimeout
+TEST(ConnectionPool, ReapsIdleConnectionsAboveMin) {
+    ConnectionPoolOptions options = sizedOptions(1, 3);
+    options.idleTimeout = std::chrono::milliseconds(50);
+    ConnectionPool pool(connectionString(), options);
+    {
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        auto third = pool.acquire();
+    }
+    EXPECT_EQ(pool.stats().size, 3u);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (pool.stats().size > 1 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ConnectionPool::Stats stats = pool.stats();
+    EXPECT_EQ(stats.size, 1u);
+    EXPECT_EQ(stats.idle, 1u);
+    EXPECT_EQ(stats.reaped, 2u);
+}
@@ -2,13 +2,19 @@
 #include <signal.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <barrier>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <sstream>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "../src/DataBase/PostgresDB.hpp"
 #include "../src/HTTP/HttpServer.hpp"
@@ -20,20 +26,22 @@ namespace http = beast::http;
 namespace net = boost::asio;
 using tcp = boost::asio::ip::tcp;
 
+// Connection string of the configured database
+static std::string testConnectionString() {
+    ConfigManager config(".env");
+    std::ostringstream oss;
+    oss << "host=" << config.get("DB_HOST")
+        << " port=" << config.getInt("DB_PORT")
+        << " dbname=" << config.get("DB_NAME")
+        << " user=" << config.get("DB_USER")
+        << " password=" << config.get("DB_PASSWORD");
+    return oss.str();
+}
+
 // Helper function to delete test data from database
 static void cleanupTestData(const std::string& guestNamePattern) {
     try {
-        ConfigManager config(".env");
-
-        // Build connection string from config
-        std::ostringstream oss;
-        oss << "host=" << config.get("DB_HOST")
-            << " port=" << config.getInt("DB_PORT")
-            << " dbname=" << config.get("DB_NAME")
-            << " user=" << config.get("DB_USER")
-            << " password=" << config.get("DB_PASSWORD");
-
-        pqxx::connection conn(oss.str());
+        pqxx::connection conn(testConnectionString());
         pqxx::work txn(conn);
 
         // Delete test data with specific guest name pattern
@@ -76,6 +84,35 @@ static std::string getValidJson(int variant = 0) {
     return oss.str();
 }
 
+// Sends one request with a Beast client and returns the parsed response
+static http::response<http::string_body> sendRequest(
+    int port, http::verb method, const std::string& target,
+    const std::string& body = "",
+    const std::string& contentType = "application/json",
+    const std::string& client = "") {
+    net::io_context ioc;
+    beast::tcp_stream stream(ioc);
+    stream.expires_after(std::chrono::seconds(5));
+    stream.connect(tcp::endpoint(net::ip::make_address("127.0.0.1"), port));
+
+    http::request<http::string_body> request{method, target, 11};
+    request.set(http::field::host, "localhost");
+    request.set(http::field::content_type, contentType);
+    if (!client.empty()) {
+        request.set("X-Client-Id", client);
+    }
+    request.body() = body;
+    request.prepare_payload();
+    http::write(stream, request);
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> response;
+    http::read(stream, buffer, response);
+    beast::error_code ec;
+    stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+    return response;
+}
+
 // HttpServer infrastructure tests
 TEST(HttpServer, ConstructorIpv4) {
     std::barrier sync_point(2);
@@ -186,3 +223,733 @@ TEST(HttpServer, PortInUse) {
     server.stop();
     std::this_thread::sleep_for(std::chrono::milliseconds(1500));
 }
+
+TEST(HttpServer, AsyncAcceptMode) {
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.acceptMode = AcceptMode::Async;
+    options.ioThreads = 4;
+    HttpServer server(&db, 8810, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // A burst of concurrent connections must all be accepted and answered
+    std::atomic<int> answered{0};
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 16; i++) {
+        clients.emplace_back([&answered]() {
+            try {
+                auto response =
+                    sendRequest(8810, http::verb::get, "/invalid/endpoint");
+                if (response.result() == http::status::not_found) {
+                    answered++;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "[HttpTest] Client error: " << e.what() << "\n";
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(answered, 16);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+TEST(HttpServer, InvalidIoThreadCount) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.acceptMode = AcceptMode::Async;
+    options.ioThreads = 0;
+    EXPECT_THROW(HttpServer(&db, 8811, options), std::invalid_argument);
+}
+
+TEST(HttpServer, CoroutineEngineServesWhileClientsIdle) {
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.sessionEngine = SessionEngine::Coroutine;
+    options.ioThreads = 2;
+    options.workerThreads = 1;
+    HttpServer server(&db, 8816, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // Far more idle connections than worker threads: none of them may hold
+    // a thread, so real requests are still answered
+    net::io_context ioc;
+    std::vector<tcp::socket> idleClients;
+    for (int i = 0; i < 32; i++) {
+        idleClients.emplace_back(ioc);
+        idleClients.back().connect(
+            tcp::endpoint(net::ip::make_address("127.0.0.1"), 8816));
+    }
+
+    auto notFound = sendRequest(8816, http::verb::get, "/invalid/endpoint");
+    EXPECT_EQ(notFound.result(), http::status::not_found);
+
+    // Database work runs on the worker pool and resumes the coroutine
+    auto created = sendRequest(8816, http::verb::post,
+                               "/application/reservation", getValidJson(7));
+    EXPECT_EQ(created.result(), http::status::ok);
+
+    for (auto& client : idleClients) {
+        client.close();
+    }
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    cleanupTestData("TestGuest");
+}
+
+TEST(HttpServer, ShardedReusePortMode) {
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.acceptMode = AcceptMode::Sharded;
+    options.sessionEngine = SessionEngine::Coroutine;
+    options.shards = 4;
+    HttpServer server(&db, 8817, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    const int connections = 64;
+    int answered = 0;
+    for (int i = 0; i < connections; i++) {
+        auto response = sendRequest(8817, http::verb::get, "/invalid");
+        if (response.result() == http::status::not_found) {
+            answered++;
+        }
+    }
+    EXPECT_EQ(answered, connections);
+
+    // Every connection was counted by exactly one shard, and the kernel
+    // spread them over more than one listener
+    auto counts = server.shardAcceptCounts();
+    ASSERT_EQ(counts.size(), 4u);
+    std::uint64_t total = 0;
+    int busyShards = 0;
+    for (auto count : counts) {
+        total += count;
+        busyShards += count > 0 ? 1 : 0;
+    }
+    EXPECT_EQ(total, static_cast<std::uint64_t>(connections));
+    EXPECT_GT(busyShards, 1);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+// A stop() that comes before start() has opened the shards still ends it
+TEST(HttpServer, ShardedStopBeforeStart) {
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.acceptMode = AcceptMode::Sharded;
+    options.shards = 2;
+    HttpServer server(&db, 8825, options);
+    server.stop();
+
+    std::atomic<bool> returned{false};
+    std::thread server_thread([&server, &returned]() {
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+        returned = true;
+    });
+    for (int i = 0; i < 50 && !returned; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_TRUE(returned) << "start() should return after an early stop()";
+    // The shards exist by now: a second stop() reaches them
+    server.stop();
+    server_thread.join();
+}
+
+TEST(HttpServer, ShedsLoadWhenQueueFull) {
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.workerThreads = 1;
+    options.queueCapacity = 1;
+    options.retryAfterSeconds = 3;
+    HttpServer server(&db, 8818, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // First idle connection holds the only worker, second fills the queue
+    auto endpoint = tcp::endpoint(net::ip::make_address("127.0.0.1"), 8818);
+    net::io_context ioc;
+    tcp::socket busy(ioc);
+    busy.connect(endpoint);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    tcp::socket queued(ioc);
+    queued.connect(endpoint);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // Third one is answered 503 right away, without sending a request
+    tcp::socket shed(ioc);
+    shed.connect(endpoint);
+    beast::flat_buffer buffer;
+    http::response<http::string_body> rejected;
+    http::read(shed, buffer, rejected);
+    EXPECT_EQ(rejected.result(), http::status::service_unavailable);
+    EXPECT_EQ(rejected[http::field::retry_after], "3");
+    EXPECT_FALSE(rejected.keep_alive());
+    EXPECT_EQ(server.metrics().rejectedConnections.load(), 1u);
+
+    // Once the worker is free again the server answers normally
+    busy.close();
+    queued.close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto metrics = sendRequest(8818, http::verb::get, "/metrics");
+    EXPECT_EQ(metrics.result(), http::status::ok);
+    EXPECT_NE(metrics.body().find("http_rejected_connections_total 1\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.body().find("http_queue_capacity 1\n"),
+              std::string::npos);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+TEST(HttpServer, IdleClientsDoNotStarveWorkers) {
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.workerThreads = 2;
+    options.headerTimeoutMs = 300;
+    HttpServer server(&db, 8819, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // Three times more silent clients than workers: each one is dropped at
+    // the header deadline, so the real request behind them is still served
+    net::io_context ioc;
+    std::vector<tcp::socket> idleClients;
+    for (int i = 0; i < 6; i++) {
+        idleClients.emplace_back(ioc);
+        idleClients.back().connect(
+            tcp::endpoint(net::ip::make_address("127.0.0.1"), 8819));
+    }
+
+    auto notFound = sendRequest(8819, http::verb::get, "/invalid/endpoint");
+    EXPECT_EQ(notFound.result(), http::status::not_found);
+
+    auto metrics = sendRequest(8819, http::verb::get, "/metrics");
+    EXPECT_EQ(metrics.result(), http::status::ok);
+    EXPECT_NE(metrics.body().find("http_timed_out_connections_total 6\n"),
+              std::string::npos);
+
+    for (auto& client : idleClients) {
+        client.close();
+    }
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+}
+
+TEST(HttpServer, BulkIngestionAndBodyLimits) {
+    cleanupTestData("TestGuest");
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.workerThreads = 2;
+    options.maxBodyBytes = 1024;
+    HttpServer server(&db, 8821, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // NDJSON over the single request limit is fine on the bulk route. The
+    // invalid line and the one the database refuses (line 5 books the
+    // room and dates of line 1 again) are reported, the others loaded.
+    std::string ndjson = getValidJson(93) + "\n" + "{\"guest_name\":1}\n" +
+                         "\n" + getValidJson(94) + "\n" + getValidJson(93) +
+                         "\n";
+    ASSERT_GT(ndjson.size(), options.maxBodyBytes);
+    auto bulk = sendRequest(8821, http::verb::post,
+                            "/application/reservations/batch", ndjson,
+                            "application/x-ndjson");
+    ASSERT_EQ(bulk.result(), http::status::ok) << bulk.body();
+    auto summary = boost::json::parse(bulk.body()).as_object();
+    EXPECT_EQ(summary.at("inserted").as_int64(), 2);
+    // Nothing else inserted meanwhile: one range
+    const auto& ids = summary.at("ids").as_array();
+    ASSERT_EQ(ids.size(), 1u);
+    const auto& range = ids.at(0).as_array();
+    int firstId = static_cast<int>(range.at(0).as_int64());
+    EXPECT_EQ(range.at(1).as_int64(), firstId + 1);
+    const auto& errors = summary.at("errors").as_array();
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_EQ(errors.at(0).as_object().at("line").as_int64(), 2);
+    EXPECT_EQ(errors.at(1).as_object().at("line").as_int64(), 5);
+    EXPECT_EQ(db.getReservationById(firstId).room_number, 193);
+    EXPECT_EQ(db.getReservationById(firstId + 1).room_number, 194);
+
+    // A JSON array with no valid element loads nothing
+    auto empty = sendRequest(8821, http::verb::post,
+                             "/application/reservations/batch",
+                             "[{\"guest_name\":1}]");
+    EXPECT_EQ(empty.result(), http::status::bad_request);
+
+    // The same size is refused on the single reservation route
+    auto tooLarge = sendRequest(8821, http::verb::post,
+                                "/application/reservation",
+                                std::string(2048, ' '));
+    EXPECT_EQ(tooLarge.result(), http::status::payload_too_large);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    cleanupTestData("TestGuest");
+}
+
+TEST(HttpServer, CachesReservationReads) {
+    cleanupTestData("TestGuest");
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ServerOptions options;
+    options.cacheEntries = 64;
+    HttpServer server(&db, 8822, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    auto created = sendRequest(8822, http::verb::post,
+                               "/application/reservation", getValidJson(95));
+    ASSERT_EQ(created.result(), http::status::ok) << created.body();
+    // "Reservation saved with ID: <id>"
+    std::string target = "/application/reservation/" +
+                         created.body().substr(created.body().rfind(' ') + 1);
+
+    // Second read is a hit with the same body
+    auto first = sendRequest(8822, http::verb::get, target);
+    auto second = sendRequest(8822, http::verb::get, target);
+    ASSERT_EQ(first.result(), http::status::ok);
+    EXPECT_EQ(second.body(), first.body());
+
+    // PUT invalidates: the next read sees the update
+    std::string changed = getValidJson(95);
+    changed.replace(changed.find("Test reservation"), 16, "Late check-in");
+    auto updated = sendRequest(8822, http::verb::put, target, changed);
+    ASSERT_EQ(updated.result(), http::status::ok);
+    auto third = sendRequest(8822, http::verb::get, target);
+    EXPECT_NE(third.body().find("Late check-in"), std::string::npos);
+
+    // DELETE invalidates too
+    sendRequest(8822, http::verb::delete_, target);
+    EXPECT_EQ(sendRequest(8822, http::verb::get, target).result(),
+              http::status::not_found);
+
+    auto metrics = sendRequest(8822, http::verb::get, "/metrics");
+    EXPECT_NE(metrics.body().find("reservation_cache_hits_total 1\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.body().find("reservation_cache_invalidations_total 2\n"),
+              std::string::npos);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    cleanupTestData("TestGuest");
+}
+
+// Writes to path the configuration of a replica that is the configured
+// database with its own reservations table, in the schema lagging_replica:
+// it holds the versions the test says the replica has replayed so far
+static void setUpLaggingReplica(pqxx::connection& admin,
+                                const std::string& path,
+                                int readYourWritesMs) {
+    {
+        pqxx::nontransaction txn(admin);
+        txn.exec("DROP SCHEMA IF EXISTS lagging_replica CASCADE");
+        txn.exec("CREATE SCHEMA lagging_replica");
+        txn.exec(
+            "CREATE TABLE lagging_replica.reservations "
+            "(LIKE public.reservations INCLUDING DEFAULTS)");
+    }
+    ConfigManager primaryConfig(".env");
+    std::ifstream base(".env");
+    std::ofstream file(path);
+    file << base.rdbuf() << "\nDB_READ_HOST=" << primaryConfig.get("DB_HOST")
+         << " options=-csearch_path=lagging_replica\n"
+         << "DB_READ_YOUR_WRITES_MS=" << readYourWritesMs << "\n";
+}
+
+static void dropLaggingReplica(pqxx::connection& admin) {
+    pqxx::nontransaction txn(admin);
+    txn.exec("DROP SCHEMA lagging_replica CASCADE");
+}
+
+// The writer's own reads go to the primary; "reader" reads the replica
+TEST(HttpServer, CacheSkipsLaggingReplica) {
+    cleanupTestData("TestGuest");
+    pqxx::connection admin(testConnectionString());
+    setUpLaggingReplica(admin, ".env.lagging_test", 60000);
+    ConfigManager config(".env.lagging_test");
+    std::remove(".env.lagging_test");
+
+    std::barrier sync_point(2);
+    PostgresDB db(config);
+    ASSERT_NE(db.getReadPool(), nullptr);
+    ServerOptions options;
+    options.cacheEntries = 64;
+    options.clientHeader = "X-Client-Id";
+    HttpServer server(&db, 8826, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    std::vector<std::string> ids;
+    for (int variant : {142, 144}) {
+        auto created = sendRequest(8826, http::verb::post,
+                                   "/application/reservation",
+                                   getValidJson(variant), "application/json",
+                                   "writer");
+        ASSERT_EQ(created.result(), http::status::ok) << created.body();
+        ids.push_back(created.body().substr(created.body().rfind(' ') + 1));
+    }
+    std::string target = "/application/reservation/" + ids[0];
+    std::string untouched = "/application/reservation/" + ids[1];
+    {
+        // The replica has both reservations as created...
+        pqxx::nontransaction txn(admin);
+        txn.exec(
+            "INSERT INTO lagging_replica.reservations "
+            "SELECT * FROM public.reservations WHERE id IN (" +
+            ids[0] + ", " + ids[1] + ")");
+    }
+    // ...but not the PUT that follows
+    std::string changed = getValidJson(142);
+    changed.replace(changed.find("Test reservation"), 16, "Late check-in");
+    auto updated = sendRequest(8826, http::verb::put, target, changed,
+                               "application/json", "writer");
+    ASSERT_EQ(updated.result(), http::status::ok);
+
+    auto stale = sendRequest(8826, http::verb::get, target, "",
+                             "application/json", "reader");
+    ASSERT_EQ(stale.result(), http::status::ok);
+    EXPECT_NE(stale.body().find("Test reservation"), std::string::npos);
+
+    // Once the replica catches up, the old version is gone: it was served,
+    // not cached
+    {
+        pqxx::nontransaction txn(admin);
+        txn.exec(
+            "UPDATE lagging_replica.reservations "
+            "SET special_requests = 'Late check-in' WHERE id = " +
+            ids[0]);
+    }
+    auto caughtUp = sendRequest(8826, http::verb::get, target, "",
+                                "application/json", "reader");
+    ASSERT_EQ(caughtUp.result(), http::status::ok);
+    EXPECT_NE(caughtUp.body().find("Late check-in"), std::string::npos);
+
+    // A reservation not written since it was cached is cached from the
+    // replica: the second read is a hit
+    auto first = sendRequest(8826, http::verb::get, untouched, "",
+                             "application/json", "reader");
+    auto second = sendRequest(8826, http::verb::get, untouched, "",
+                              "application/json", "reader");
+    ASSERT_EQ(first.result(), http::status::ok);
+    EXPECT_EQ(second.body(), first.body());
+
+    auto metrics = sendRequest(8826, http::verb::get, "/metrics");
+    EXPECT_NE(metrics.body().find("reservation_cache_hits_total 1\n"),
+              std::string::npos);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    dropLaggingReplica(admin);
+    cleanupTestData("TestGuest");
+}
+
+// Behind a proxy every client has the proxy's address: with a client
+// header, one client's write does not send the others' reads to the primary
+TEST(HttpServer, ReadYourWritesByClientHeader) {
+    cleanupTestData("TestGuest");
+    pqxx::connection admin(testConnectionString());
+    setUpLaggingReplica(admin, ".env.client_header_test", 60000);
+    ConfigManager config(".env.client_header_test");
+    std::remove(".env.client_header_test");
+
+    std::barrier sync_point(2);
+    PostgresDB db(config);
+    ServerOptions options;
+    options.clientHeader = "X-Client-Id";
+    HttpServer server(&db, 8827, options);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // The replica never gets this reservation
+    auto created = sendRequest(8827, http::verb::post,
+                               "/application/reservation", getValidJson(143),
+                               "application/json", "writer");
+    ASSERT_EQ(created.result(), http::status::ok) << created.body();
+    std::string target = "/application/reservation/" +
+                         created.body().substr(created.body().rfind(' ') + 1);
+
+    // The writer reads its write back from the primary...
+    EXPECT_EQ(sendRequest(8827, http::verb::get, target, "",
+                          "application/json", "writer")
+                  .result(),
+              http::status::ok);
+    // ...while another client, from the same address, reads the replica
+    EXPECT_EQ(sendRequest(8827, http::verb::get, target, "",
+                          "application/json", "reader")
+                  .result(),
+              http::status::not_found);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    dropLaggingReplica(admin);
+    cleanupTestData("TestGuest");
+}
+
+TEST(HttpServer, SearchAndAvailability) {
+    cleanupTestData("TestGuest");
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    HttpServer server(&db, 8823);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // Room 240, staying from 2026-02-15 to 2026-02-18
+    auto created = sendRequest(8823, http::verb::post,
+                               "/application/reservation", getValidJson(140));
+    ASSERT_EQ(created.result(), http::status::ok) << created.body();
+    int id = std::stoi(created.body().substr(created.body().rfind(' ') + 1));
+
+    auto search = [](const std::string& query) {
+        return sendRequest(8823, http::verb::get,
+                           "/application/reservations?" + query);
+    };
+    auto found = search("room_number=240&from=2026-02-17&to=2026-03-01"
+                        "&status=confirmed");
+    ASSERT_EQ(found.result(), http::status::ok) << found.body();
+    boost::json::array items = boost::json::parse(found.body())
+                                   .as_object()
+                                   .at("items")
+                                   .as_array();
+    ASSERT_EQ(items.size(), 1u);
+    EXPECT_EQ(items[0].as_object().at("id").as_int64(), id);
+    EXPECT_EQ(items[0].as_object().at("guest_name").as_string(),
+              "TestGuest140");
+
+    auto itemCount = [](const http::response<http::string_body>& response) {
+        return boost::json::parse(response.body())
+            .as_object()
+            .at("items")
+            .as_array()
+            .size();
+    };
+    EXPECT_EQ(itemCount(search("room_number=240&from=2026-02-19")), 0u);
+    EXPECT_EQ(itemCount(search("room_number=240&status=cancelled")), 0u);
+    EXPECT_EQ(itemCount(search("room_number=240&limit=1")), 1u);
+
+    EXPECT_EQ(search("room_number=abc").result(), http::status::bad_request);
+    EXPECT_EQ(search("from=2026-02-30").result(), http::status::bad_request);
+    EXPECT_EQ(search("from=2026-03-01&to=2026-02-01").result(),
+              http::status::bad_request);
+    EXPECT_EQ(search("limit=100000").result(), http::status::bad_request);
+    EXPECT_EQ(search("colour=blue").result(), http::status::bad_request);
+
+    auto availability = [](const std::string& query) {
+        auto response = sendRequest(
+            8823, http::verb::get,
+            "/application/rooms/240/availability?" + query);
+        EXPECT_EQ(response.result(), http::status::ok) << response.body();
+        return boost::json::parse(response.body()).as_object();
+    };
+    // Checking out the day the next guest checks in counts as an overlap
+    boost::json::object busy = availability("from=2026-02-18&to=2026-02-20");
+    EXPECT_FALSE(busy.at("available").as_bool());
+    EXPECT_EQ(busy.at("conflicts").as_array().size(), 1u);
+    EXPECT_EQ(busy.at("conflicts").as_array()[0].as_int64(), id);
+    boost::json::object vacant = availability("from=2026-02-19&to=2026-02-21");
+    EXPECT_TRUE(vacant.at("available").as_bool());
+    EXPECT_TRUE(vacant.at("conflicts").as_array().empty());
+
+    EXPECT_EQ(sendRequest(8823, http::verb::get,
+                          "/application/rooms/240/availability?from=2026-02-19")
+                  .result(),
+              http::status::bad_request);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    cleanupTestData("TestGuest");
+}
+
+// Exports arrive with chunked transfer encoding, in both formats
+TEST(HttpServer, ExportStreamsChunked) {
+    cleanupTestData("TestGuest");
+    std::barrier sync_point(2);
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    HttpServer server(&db, 8824);
+    std::thread server_thread([&sync_point, &server]() {
+        sync_point.arrive_and_wait();
+        try {
+            server.start();
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpTest] Server error: " << e.what() << "\n";
+        }
+    });
+    server_thread.detach();
+
+    sync_point.arrive_and_wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // Room 241
+    auto created = sendRequest(8824, http::verb::post,
+                               "/application/reservation", getValidJson(141));
+    ASSERT_EQ(created.result(), http::status::ok) << created.body();
+    int id = std::stoi(created.body().substr(created.body().rfind(' ') + 1));
+
+    auto exported = [](const std::string& query) {
+        return sendRequest(8824, http::verb::get,
+                           "/application/reservations/export?" + query);
+    };
+    auto csv = exported("room_number=241");
+    ASSERT_EQ(csv.result(), http::status::ok) << csv.body();
+    EXPECT_TRUE(csv.chunked());
+    EXPECT_EQ(csv[http::field::content_type], "text/csv");
+    std::istringstream lines(csv.body());
+    std::string header;
+    std::string row;
+    std::string extra;
+    std::getline(lines, header);
+    std::getline(lines, row);
+    EXPECT_EQ(header.rfind("id,guest_name,", 0), 0u) << header;
+    EXPECT_EQ(row.rfind(std::to_string(id) + ",TestGuest141,", 0), 0u)
+        << row;
+    EXPECT_FALSE(std::getline(lines, extra));
+
+    auto ndjson = exported("room_number=241&format=ndjson");
+    ASSERT_EQ(ndjson.result(), http::status::ok) << ndjson.body();
+    EXPECT_TRUE(ndjson.chunked());
+    ASSERT_EQ(ndjson.body().back(), '\n');
+    boost::json::object item = boost::json::parse(ndjson.body()).as_object();
+    EXPECT_EQ(item.at("id").as_int64(), id);
+    EXPECT_EQ(item.at("guest_name").as_string(), "TestGuest141");
+
+    // Nothing matches: a header line, no rows
+    auto none = exported("room_number=241&status=cancelled");
+    ASSERT_EQ(none.result(), http::status::ok);
+    EXPECT_EQ(std::count(none.body().begin(), none.body().end(), '\n'), 1);
+
+    EXPECT_EQ(exported("format=xml").result(), http::status::bad_request);
+    EXPECT_EQ(exported("limit=10").result(), http::status::bad_request);
+
+    server.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    cleanupTestData("TestGuest");
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "../src/DataBase/InsertBatcher.hpp"
+#include "../src/DataBase/PostgresDB.hpp"
+#include "../src/config/ConfigManager.hpp"
+
+static Reservation createBaseReservation(int room) {
+    Reservation res;
+    res.guest_name = "TESTING_OWNER";
+    res.guest_email = "batch@example.com";
+    res.guest_phone = "+34612345678";
+    res.room_number = room;
+    res.room_type = "Doble";
+    res.number_of_guests = 2;
+    res.check_in_date = "2026-02-15";
+    res.check_out_date = "2026-02-18";
+    res.number_of_nights = 3;
+    res.price_per_night = 150.0;
+    res.total_price = 450.0;
+    res.payment_method = "credit_card";
+    res.paid = true;
+    res.reservation_status = "confirmed";
+    res.special_requests = "Test";
+    res.created_at = 1707427200;
+    res.updated_at = 1707427200;
+    return res;
+}
+
+static void cleanupTestData() {
+    try {
+        ConfigManager config(".env");
+        std::ostringstream oss;
+        oss << "host=" << config.get("DB_HOST")
+            << " port=" << config.getInt("DB_PORT")
+            << " dbname=" << config.get("DB_NAME")
+            << " user=" << config.get("DB_USER")
+            << " password=" << config.get("DB_PASSWORD");
+
+        pqxx::connection conn(oss.str());
+        pqxx::work txn(conn);
+        txn.exec("DELETE FROM reservations WHERE guest_name='TESTING_OWNER'");
+        txn.commit();
+    } catch (const std::exception& e) {
+        std::cerr << "Cleanup failed: " << e.what() << "\n";
+    }
+}
+
+static InsertBatcherOptions batchOptions(std::size_t size,
+                                         std::chrono::milliseconds delay) {
+    InsertBatcherOptions options;
+    options.maxBatchSize = size;
+    options.maxDelay = delay;
+    return options;
+}
+
+// Rows submitted together are written by one INSERT, and each caller gets
+// the ID of its own row
+TEST(InsertBatcher, SubmissionsShareOneBatch) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    {
+        InsertBatcher batcher(db,
+                              batchOptions(8, std::chrono::milliseconds(500)));
+        std::vector<std::future<int>> ids;
+        for (int i = 0; i < 8; i++) {
+            ids.push_back(batcher.submit(createBaseReservation(180 + i)));
+        }
+
+        std::set<int> distinct;
+        for (int i = 0; i < 8; i++) {
+            int id = ids[i].get();
+            ASSERT_NE(id, -1) << "Row " << i << " should be inserted";
+            distinct.insert(id);
+            EXPECT_EQ(db.getReservationById(id).room_number, 180 + i);
+        }
+        EXPECT_EQ(distinct.size(), 8u);
+
+        InsertBatcher::Stats stats = batcher.stats();
+        EXPECT_EQ(stats.batches, 1u);
+        EXPECT_EQ(stats.rows, 8u);
+        EXPECT_EQ(stats.fallbacks, 0u);
+    }
+    cleanupTestData();
+}
+
+// A row that overlaps another one fails alone: the batch is retried row by
+// row and only that caller gets -1
+TEST(InsertBatcher, RejectedRowDoesNotFailTheBatch) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    {
+        InsertBatcher batcher(db,
+                              batchOptions(3, std::chrono::milliseconds(500)));
+        auto first = batcher.submit(createBaseReservation(190));
+        auto overlapping = batcher.submit(createBaseReservation(190));
+        auto other = batcher.submit(createBaseReservation(191));
+
+        EXPECT_NE(first.get(), -1);
+        EXPECT_EQ(overlapping.get(), -1);
+        EXPECT_NE(other.get(), -1);
+        EXPECT_EQ(batcher.stats().fallbacks, 1u);
+    }
+    cleanupTestData();
+}
+
+// Nothing is lost on shutdown: pending rows are written before the flusher
+// stops, without waiting for the batch delay
+TEST(InsertBatcher, FlushesPendingRowsOnDestruction) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    std::future<int> id;
+    auto start = std::chrono::steady_clock::now();
+    {
+        InsertBatcher batcher(db,
+                              batchOptions(8, std::chrono::milliseconds(10000)));
+        id = batcher.submit(createBaseReservation(192));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::seconds(5));
+    ASSERT_EQ(id.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_NE(id.get(), -1);
+    cleanupTestData();
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+
 #include "../src/HTTP/JsonHandler.hpp"
+#include "../src/HTTP/RequestBody.hpp"
+#include "AllocationCounter.hpp"
 
 TEST(JsonHandler, ValidReservationJson) {
     std::string validJson = R"({
@@ -277,4 +281,219 @@ TEST(JsonHandler, ReservationToJson) {
     EXPECT_EQ(parsedRes.price_per_night, 150.50);
     EXPECT_EQ(parsedRes.total_price, 752.50);
     EXPECT_EQ(parsedRes.paid, true);
-}
\ No newline at end of file
+}
+
+TEST(JsonHandler, ParseFromDocument) {
+    boost::json::value document = boost::json::parse(R"({
+        "guest_name": "Ana",
+        "guest_email": "ana@example.com",
+        "guest_phone": "+34 600 000 000",
+        "room_number": 12,
+        "room_type": "Single",
+        "number_of_guests": 1,
+        "check_in_date": "2026-03-01",
+        "check_out_date": "2026-03-02",
+        "number_of_nights": 1,
+        "price_per_night": 80.0,
+        "total_price": 80.0,
+        "payment_method": "cash",
+        "paid": true,
+        "created_at": 1707124800,
+        "updated_at": 1707124800
+    })");
+    JsonHandler jsonHandler;
+    Reservation res = jsonHandler.parseJson(document);
+    EXPECT_EQ(res.guest_name, "Ana");
+    EXPECT_EQ(res.room_number, 12);
+    EXPECT_TRUE(res.paid);
+
+    EXPECT_THROW(jsonHandler.parseJson(boost::json::value(42)),
+                 std::invalid_argument);
+}
+
+// What reservationToJson produced before it wrote the JSON by hand
+static std::string serializeWithDom(const Reservation& res) {
+    boost::json::object jsonObj;
+    jsonObj["guest_name"] = res.guest_name;
+    jsonObj["guest_email"] = res.guest_email;
+    jsonObj["guest_phone"] = res.guest_phone;
+    jsonObj["room_number"] = res.room_number;
+    jsonObj["room_type"] = res.room_type;
+    jsonObj["number_of_guests"] = res.number_of_guests;
+    jsonObj["check_in_date"] = res.check_in_date;
+    jsonObj["check_out_date"] = res.check_out_date;
+    jsonObj["number_of_nights"] = res.number_of_nights;
+    jsonObj["price_per_night"] = res.price_per_night;
+    jsonObj["total_price"] = res.total_price;
+    jsonObj["payment_method"] = res.payment_method;
+    jsonObj["paid"] = res.paid;
+    jsonObj["reservation_status"] = res.reservation_status;
+    jsonObj["special_requests"] = res.special_requests;
+    jsonObj["created_at"] = res.created_at;
+    jsonObj["updated_at"] = res.updated_at;
+    return boost::json::serialize(jsonObj);
+}
+
+static Reservation sampleReservation() {
+    Reservation res;
+    res.guest_name = "Juan P\xc3\xa9rez";
+    res.guest_email = "juan@example.com";
+    res.guest_phone = "+34 123 456 789";
+    res.room_number = 101;
+    res.room_type = "Double";
+    res.number_of_guests = 2;
+    res.check_in_date = "2026-02-15";
+    res.check_out_date = "2026-02-20";
+    res.number_of_nights = 5;
+    res.price_per_night = 150.50;
+    res.total_price = 752.50;
+    res.payment_method = "credit_card";
+    res.paid = true;
+    res.reservation_status = "confirmed";
+    res.special_requests = "No smoking";
+    res.created_at = 1707124800;
+    res.updated_at = 1707124800;
+    return res;
+}
+
+TEST(JsonHandler, ReservationToJsonMatchesBoostSerialize) {
+    JsonHandler jsonHandler;
+    Reservation res = sampleReservation();
+    EXPECT_EQ(jsonHandler.reservationToJson(res), serializeWithDom(res));
+
+    // Every escape the serializer knows about, and awkward numbers
+    res.special_requests =
+        std::string("quote \" slash / backslash \\ \b\f\n\r\t ") +
+        '\0' + "\x01\x1f\x7f end";
+    res.guest_name = "";
+    res.room_number = -7;
+    res.created_at = std::numeric_limits<long>::max();
+    res.paid = false;
+    for (double price : {0.0, -0.0, 1.0, 0.1, 1e21, 1e-7, 123456789.125,
+                         5e-324, 1.7976931348623157e308, -42.5}) {
+        res.price_per_night = price;
+        res.total_price = price * 3;
+        EXPECT_EQ(jsonHandler.reservationToJson(res), serializeWithDom(res))
+            << price;
+    }
+}
+
+TEST(JsonHandler, ReservationToJsonReusesBuffer) {
+    JsonHandler jsonHandler;
+    Reservation res = sampleReservation();
+    std::string out = "previous content";
+    jsonHandler.reservationToJson(res, out);
+    EXPECT_EQ(out, serializeWithDom(res));
+
+    // The buffer already has the capacity: no more allocations
+    auto before = allocationsOnThisThread();
+    for (int i = 0; i < 100; i++) {
+        jsonHandler.reservationToJson(res, out);
+    }
+    EXPECT_EQ(allocationsOnThisThread() - before, 0u);
+    EXPECT_EQ(out, serializeWithDom(res));
+}
+
+TEST(JsonHandler, ReservationsToJsonListsItemsWithIds) {
+    JsonHandler jsonHandler;
+    Reservation res = sampleReservation();
+    std::string out = "previous content";
+    jsonHandler.reservationsToJson({}, out);
+    EXPECT_EQ(out, R"({"items":[]})");
+
+    jsonHandler.reservationsToJson({{7, res}, {9, res}}, out);
+    boost::json::object withId = boost::json::parse(serializeWithDom(res))
+                                     .as_object();
+    withId["id"] = 7;
+    boost::json::object parsed = boost::json::parse(out).as_object();
+    const boost::json::array& items = parsed.at("items").as_array();
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0], withId);
+    EXPECT_EQ(items[1].as_object().at("id").as_int64(), 9);
+    EXPECT_EQ(out.substr(0, 17), R"({"items":[{"id":7)");
+}
+
+TEST(JsonHandler, ReservationListWrittenItemByItem) {
+    JsonHandler jsonHandler;
+    Reservation res = sampleReservation();
+    std::string expected;
+    jsonHandler.reservationsToJson({{7, res}, {9, res}}, expected);
+
+    std::string out = "previous content";
+    jsonHandler.beginReservationList(out);
+    jsonHandler.appendReservationItem(7, res, out);
+    jsonHandler.appendReservationItem(9, res, out);
+    jsonHandler.endReservationList(out);
+    EXPECT_EQ(out, expected);
+
+    jsonHandler.beginReservationList(out);
+    jsonHandler.appendReservationItem(7, res, out);
+    jsonHandler.endReservationList(out, "aS40Mg");
+    boost::json::object parsed = boost::json::parse(out).as_object();
+    EXPECT_EQ(parsed.at("items").as_array().size(), 1u);
+    EXPECT_EQ(parsed.at("next_cursor").as_string(), "aS40Mg");
+}
+
+TEST(JsonHandler, ArenaParseDoesNotAllocateWhenWarm) {
+    JsonParseContext context;
+    JsonHandler jsonHandler;
+    Reservation scratch;
+    std::string text = R"({
+        "guest_name": "Juan P\u00e9rez, a name longer than the SSO buffer",
+        "guest_email": "juan.perez.long.address@example.com",
+        "guest_phone": "+34 123 456 789",
+        "room_number": 101,
+        "room_type": "Double with sea view",
+        "number_of_guests": 2,
+        "check_in_date": "2026-02-15",
+        "check_out_date": "2026-02-20",
+        "number_of_nights": 5,
+        "price_per_night": 150.50,
+        "total_price": 752.50,
+        "payment_method": "credit_card",
+        "paid": false,
+        "special_requests": "Late check-in after midnight, quiet room",
+        "created_at": 1707124800,
+        "updated_at": 1707124800
+    })";
+    auto parseOnce = [&]() {
+        context.reset();
+        boost::json::stream_parser& parser = context.parser();
+        boost::json::error_code ec;
+        parser.write(text.data(), text.size(), ec);
+        parser.finish(ec);
+        ASSERT_FALSE(ec);
+        boost::json::value document = parser.release();
+        jsonHandler.parseJson(document, scratch);
+    };
+
+    // Warm-up: arena buffer, parser stacks and scratch string capacity
+    parseOnce();
+    auto before = allocationsOnThisThread();
+    for (int i = 0; i < 100; i++) {
+        parseOnce();
+    }
+    EXPECT_EQ(allocationsOnThisThread() - before, 0u);
+    EXPECT_EQ(scratch.room_type, "Double with sea view");
+    EXPECT_EQ(scratch.price_per_night, 150.50);
+}
+
+TEST(JsonHandler, ScratchReservationForgetsOptionalFields) {
+    JsonHandler jsonHandler;
+    Reservation scratch;
+    scratch.special_requests = "from a previous request";
+    scratch.reservation_status = "cancelled";
+    jsonHandler.parseJson(boost::json::parse(R"({
+        "guest_name": "Ana", "guest_email": "ana@example.com",
+        "guest_phone": "+34 600 000 000", "room_number": 12,
+        "room_type": "Single", "number_of_guests": 1,
+        "check_in_date": "2026-03-01", "check_out_date": "2026-03-02",
+        "number_of_nights": 1, "price_per_night": 80.0,
+        "total_price": 80.0, "payment_method": "cash", "paid": true,
+        "created_at": 1707124800, "updated_at": 1707124800
+    })"),
+                          scratch);
+    EXPECT_EQ(scratch.guest_name, "Ana");
+    EXPECT_TRUE(scratch.special_requests.empty());
+    EXPECT_TRUE(scratch.reservation_status.empty());
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "../src/HTTP/PageCursor.hpp"
+
+TEST(PageCursor, RoundTripsBothOrders) {
+    ReservationKey byId;
+    byId.id = 123456;
+    std::string cursor = PageCursor::encode(ReservationOrder::Id, byId);
+    EXPECT_EQ(cursor.find_first_not_of(
+                  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                  "0123456789-_"),
+              std::string::npos)
+        << "Safe in a query string as is";
+    EXPECT_EQ(PageCursor::decode(cursor, ReservationOrder::Id).id, 123456);
+
+    ReservationKey byDate;
+    byDate.id = 7;
+    byDate.checkInDate = "2026-02-15";
+    ReservationKey decoded = PageCursor::decode(
+        PageCursor::encode(ReservationOrder::CheckInDate, byDate),
+        ReservationOrder::CheckInDate);
+    EXPECT_EQ(decoded.id, 7);
+    EXPECT_EQ(decoded.checkInDate, "2026-02-15");
+}
+
+TEST(PageCursor, RejectsForeignCursors) {
+    ReservationKey key;
+    key.id = 42;
+    key.checkInDate = "2026-02-15";
+    EXPECT_THROW(
+        PageCursor::decode(PageCursor::encode(ReservationOrder::Id, key),
+                           ReservationOrder::CheckInDate),
+        std::invalid_argument);
+    EXPECT_THROW(PageCursor::decode(
+                     PageCursor::encode(ReservationOrder::CheckInDate, key),
+                     ReservationOrder::Id),
+                 std::invalid_argument);
+    EXPECT_THROW(PageCursor::decode("not a cursor", ReservationOrder::Id),
+                 std::invalid_argument);
+    EXPECT_THROW(PageCursor::decode("", ReservationOrder::Id),
+                 std::invalid_argument);
+}
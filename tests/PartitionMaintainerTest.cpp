@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <pqxx/pqxx>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/DataBase/PartitionMaintainer.hpp"
+#include "../src/config/ConfigManager.hpp"
+
+static void dropTestSchemas(pqxx::connection& conn) {
+    pqxx::nontransaction txn(conn);
+    txn.exec("DROP SCHEMA IF EXISTS partition_test CASCADE");
+    txn.exec("DROP SCHEMA IF EXISTS partition_test_archive CASCADE");
+}
+
+// The tables live in their own schemas, partition_test and its archive
+// partition_test_archive, recreated by every test: the real reservations
+// table is left alone
+static pqxx::connection connectToTestSchema() {
+    ConfigManager config(".env");
+    std::ostringstream oss;
+    oss << "host=" << config.get("DB_HOST")
+        << " port=" << config.getInt("DB_PORT")
+        << " dbname=" << config.get("DB_NAME")
+        << " user=" << config.get("DB_USER")
+        << " password=" << config.get("DB_PASSWORD")
+        << " options='-c search_path=partition_test'";
+    pqxx::connection conn(oss.str());
+    dropTestSchemas(conn);
+    {
+        pqxx::nontransaction txn(conn);
+        txn.exec("CREATE SCHEMA partition_test");
+    }
+    return conn;
+}
+
+static std::chrono::year_month month(int year, unsigned number) {
+    return std::chrono::year(year) / std::chrono::month(number);
+}
+
+// Inserts a stay in room 1; false if the database rejects it
+static bool insertStay(pqxx::connection& conn, const std::string& checkIn,
+                       const std::string& checkOut) {
+    try {
+        pqxx::work txn(conn);
+        pqxx::params p;
+        p.append(checkIn);
+        p.append(checkOut);
+        txn.exec(R"(
+            INSERT INTO reservations (
+                guest_name, guest_email, guest_phone,
+                room_number, room_type, number_of_guests,
+                check_in_date, check_out_date, number_of_nights,
+                price_per_night, total_price, payment_method, paid,
+                reservation_status, special_requests,
+                created_at, updated_at
+            ) VALUES (
+                'PARTITION_TEST', 'partition@example.com', '+34612345678',
+                1, 'Doble', 2, $1::date, $2::date, 1,
+                100.0, 100.0, 'credit_card', true,
+                'confirmed', '', 1707427200, 1707427200
+            ))",
+                 p);
+        txn.commit();
+        return true;
+    } catch (const pqxx::sql_error&) {
+        return false;
+    }
+}
+
+TEST(PartitionMaintainer, PartitionNames) {
+    EXPECT_EQ(PartitionMaintainer::partitionName(month(2026, 2)),
+              "reservations_2026_02");
+    EXPECT_EQ(PartitionMaintainer::partitionName(month(2026, 12)),
+              "reservations_2026_12");
+    EXPECT_EQ(PartitionMaintainer::partitionMonth("reservations_2026_02"),
+              month(2026, 2));
+    EXPECT_FALSE(PartitionMaintainer::partitionMonth("reservations_2026_13"));
+    EXPECT_FALSE(PartitionMaintainer::partitionMonth("reservations_2026-02"));
+    EXPECT_FALSE(PartitionMaintainer::partitionMonth("reservations"));
+}
+
+// Stays are checked against the window before they reach the database
+TEST(PartitionMaintainer, CheckStayWindow) {
+    PartitionOptions options;
+    options.monthsAhead = 2;
+    options.monthsBehind = 1;
+    auto check = [&options](const char* checkIn, const char* checkOut) {
+        PartitionMaintainer::checkStay(options, month(2026, 3), checkIn,
+                                       checkOut);
+    };
+    EXPECT_NO_THROW(check("2026-02-01", "2026-02-03"));
+    EXPECT_NO_THROW(check("2026-05-31", "2026-06-02"));
+    EXPECT_THROW(check("2026-01-31", "2026-02-02"), StayOutsidePartitions);
+    EXPECT_THROW(check("2026-06-01", "2026-06-03"), StayOutsidePartitions);
+    try {
+        check("2027-01-10", "2027-01-12");
+        ADD_FAILURE() << "A stay past the window should be refused";
+    } catch (const StayOutsidePartitions& e) {
+        EXPECT_NE(std::string(e.what()).find("2026-02-01 to 2026-05-31"),
+                  std::string::npos)
+            << e.what();
+    }
+    // kMaxStayDays nights at most
+    EXPECT_NO_THROW(check("2026-03-01", "2027-03-02"));
+    EXPECT_THROW(check("2026-03-01", "2027-03-03"), StayOutsidePartitions);
+    // Malformed dates are the database's to refuse
+    EXPECT_NO_THROW(check("2030-13-01", "2030-13-02"));
+}
+
+// Months are created ahead, stays are checked for overlaps across
+// partitions, and months past the retention move to the archive schema
+TEST(PartitionMaintainer, CreatesAndArchivesMonths) {
+    pqxx::connection conn = connectToTestSchema();
+    ASSERT_TRUE(PartitionMaintainer::bootstrap(conn));
+    EXPECT_TRUE(PartitionMaintainer::isPartitioned(conn));
+    // Already there: nothing to do
+    EXPECT_TRUE(PartitionMaintainer::bootstrap(conn));
+
+    PartitionOptions options;
+    options.monthsAhead = 2;
+    options.monthsBehind = 1;
+    options.retentionMonths = 2;
+    options.archiveSchema = "partition_test_archive";
+    auto pass = PartitionMaintainer::maintain(conn, options, month(2026, 3));
+    // Up to two months ahead, and a spare one
+    std::vector<std::string> months = {
+        "reservations_2026_02", "reservations_2026_03",
+        "reservations_2026_04", "reservations_2026_05",
+        "reservations_2026_06"};
+    EXPECT_EQ(pass.created, months);
+    EXPECT_TRUE(pass.archived.empty());
+    EXPECT_TRUE(
+        PartitionMaintainer::maintain(conn, options, month(2026, 3))
+            .created.empty());
+
+    // February's stay runs into March: a March stay overlapping it is in
+    // another partition, and still rejected
+    EXPECT_TRUE(insertStay(conn, "2026-02-27", "2026-03-02"));
+    EXPECT_FALSE(insertStay(conn, "2026-03-02", "2026-03-04"));
+    EXPECT_TRUE(insertStay(conn, "2026-03-03", "2026-03-05"));
+    // No partition that far ahead, and a stay longer than allowed
+    EXPECT_FALSE(insertStay(conn, "2027-01-10", "2027-01-12"));
+    EXPECT_FALSE(insertStay(conn, "2026-04-01", "2027-04-10"));
+
+    pass = PartitionMaintainer::maintain(conn, options, month(2026, 5));
+    EXPECT_EQ(pass.created,
+              (std::vector<std::string>{"reservations_2026_07",
+                                        "reservations_2026_08"}));
+    EXPECT_EQ(pass.archived,
+              std::vector<std::string>{"reservations_2026_02"});
+    {
+        pqxx::nontransaction txn(conn);
+        EXPECT_EQ(txn.exec("SELECT count(*) FROM reservations")[0][0]
+                      .as<int>(),
+                  1);
+        EXPECT_EQ(txn.exec("SELECT count(*) FROM "
+                           "partition_test_archive.reservations_2026_02")[0][0]
+                      .as<int>(),
+                  1);
+    }
+
+    options.retentionMonths = 1;
+    EXPECT_THROW(PartitionMaintainer::maintain(conn, options, month(2026, 5)),
+                 std::invalid_argument);
+    dropTestSchemas(conn);
+}
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include <thread>
 #include <vector>
 
+#include "../src/DataBase/BulkLoader.hpp"
 #include "../src/DataBase/PostgresDB.hpp"
 #include "../src/config/ConfigManager.hpp"
 
@@ -165,10 +169,21 @@ TEST(PostgresDB, GetReservationByIdNotFound) {
     ConfigManager config(".env");
     PostgresDB db(config);
 
-    // Try to get non-existent ID - should throw std::runtime_error
+    // Try to get non-existent ID - should throw ReservationNotFound
     EXPECT_THROW(
         { Reservation res = db.getReservationById(999999); },
-        std::runtime_error);
+        ReservationNotFound);
+
+    // A failing connection is a database error, not a missing reservation
+    auto conn = db.getConnectionPool()->acquire();
+    conn->close();
+    try {
+        db.getReservationById(*conn, 999999);
+        ADD_FAILURE() << "A closed connection should throw";
+    } catch (const ReservationNotFound&) {
+        ADD_FAILURE() << "Reported as not found";
+    } catch (const std::exception&) {
+    }
 
     cleanupTestData();
 }
@@ -328,6 +343,440 @@ TEST(PostgresDB, ConcurrentInserts) {
     cleanupTestData();
 }
 
+// Test get, update and delete on pool connections, reads from several
+// threads at once
+TEST(PostgresDB, PoolConnectionOperations) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ConnectionPool* pool = db.getConnectionPool();
+
+    Reservation res = createBaseReservation();
+    res.room_number = 175;
+    int id = db.insertReservation(*pool->acquire(), res);
+    ASSERT_NE(id, -1) << "Insertion should succeed";
+
+    std::vector<std::thread> threads;
+    std::vector<int> rooms(4, 0);
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&db, pool, &rooms, id, i]() {
+            auto readConn = pool->acquire();
+            rooms[i] = db.getReservationById(*readConn, id).room_number;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(rooms[i], 175) << "Concurrent read " << i << " failed";
+    }
+
+    auto conn = pool->acquire();
+    Reservation updated = createBaseReservation();
+    updated.room_number = 175;
+    updated.guest_name = "UPDATED_GUEST";
+    EXPECT_TRUE(db.updateReservation(*conn, id, updated));
+    EXPECT_EQ(db.getReservationById(*conn, id).guest_name, "UPDATED_GUEST");
+    EXPECT_FALSE(db.updateReservation(*conn, 999999, updated));
+
+    EXPECT_TRUE(db.deleteReservation(*conn, id));
+    EXPECT_FALSE(db.deleteReservation(*conn, id));
+    EXPECT_THROW(db.getReservationById(*conn, id), std::runtime_error);
+
+    cleanupTestData();
+}
+
+// Queries run as prepared statements: a pool connection opened to replace
+// a broken one must have them prepared too
+TEST(PostgresDB, PreparedStatementsSurviveReconnect) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ConnectionPool* pool = db.getConnectionPool();
+
+    std::uint64_t reconnects = pool->stats().reconnects;
+    {
+        auto conn = pool->acquire();
+        conn->close();
+    }
+    auto conn = pool->acquire();
+    EXPECT_EQ(pool->stats().reconnects, reconnects + 1);
+
+    Reservation res = createBaseReservation();
+    res.room_number = 176;
+    int id = db.insertReservation(*conn, res);
+    ASSERT_NE(id, -1) << "Insert on the new connection should succeed";
+    EXPECT_EQ(db.getReservationById(*conn, id).room_number, 176);
+
+    cleanupTestData();
+}
+
+// Pipelined batches answer per item, in order, and the connection works
+// normally once the pipeline is over
+TEST(PostgresDB, PipelinedGetsAndUpdates) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    auto conn = db.getConnectionPool()->acquire();
+
+    // More items than kPipelineDepth, so results are read while sending
+    std::vector<int> ids;
+    for (int room = 195; room < 198; room++) {
+        Reservation res = createBaseReservation();
+        res.room_number = room;
+        ids.push_back(db.insertReservation(*conn, res));
+        ASSERT_NE(ids.back(), -1) << "Insertion should succeed";
+    }
+    std::vector<int> lookups;
+    for (std::size_t i = 0; i < PostgresDB::kPipelineDepth + 10; i++) {
+        lookups.push_back(i % 2 == 0 ? ids[i % ids.size()] : 999999);
+    }
+    auto found = db.getReservationsById(*conn, lookups);
+    ASSERT_EQ(found.size(), lookups.size());
+    for (std::size_t i = 0; i < lookups.size(); i++) {
+        if (lookups[i] == 999999) {
+            EXPECT_FALSE(found[i].has_value()) << "Lookup " << i;
+        } else {
+            ASSERT_TRUE(found[i].has_value()) << "Lookup " << i;
+            EXPECT_EQ(found[i]->room_number,
+                      195 + static_cast<int>(i % ids.size()));
+        }
+    }
+    // The lookups' read-only transaction ended with the batch: the
+    // connection stays open and the updates below can write
+    ASSERT_TRUE(conn->is_open());
+    {
+        pqxx::nontransaction txn(*conn);
+        EXPECT_TRUE(txn.exec("SELECT now() = statement_timestamp()")[0][0]
+                        .as<bool>())
+            << "No transaction block should be left open";
+    }
+
+    // The overlapping update fails alone, the ones after it still commit
+    Reservation renamed = createBaseReservation();
+    renamed.room_number = 195;
+    renamed.special_requests = "Pipelined";
+    Reservation overlapping = createBaseReservation();
+    overlapping.room_number = 195;
+    Reservation moved = createBaseReservation();
+    moved.room_number = 198;
+    auto updated = db.updateReservations(
+        *conn, {{ids[0], renamed}, {ids[1], overlapping}, {ids[2], moved},
+                {999999, moved}});
+    EXPECT_EQ(updated, (std::vector<bool>{true, false, true, false}));
+
+    EXPECT_EQ(db.getReservationById(*conn, ids[0]).special_requests,
+              "Pipelined");
+    EXPECT_EQ(db.getReservationById(*conn, ids[1]).room_number, 196);
+    EXPECT_EQ(db.getReservationById(*conn, ids[2]).room_number, 198);
+
+    cleanupTestData();
+}
+
+// Rows are committed a chunk at a time. A refused row fails the COPY of
+// its chunk only, and is reported by its line once the rest of the chunk
+// is loaded one by one.
+TEST(PostgresDB, BulkLoaderReportsRefusedRows) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    auto conn = db.getConnectionPool()->acquire();
+
+    // One room each, 1000 and up; line kChunkRows + 2 books the room of
+    // line 1 again, in the second chunk
+    std::size_t lines = BulkLoader::kChunkRows + 3;
+    std::size_t overlapping = BulkLoader::kChunkRows + 2;
+    BulkLoader loader(*conn, lines);
+    for (std::size_t line = 1; line <= lines; line++) {
+        Reservation res = createBaseReservation();
+        res.room_number = line == overlapping
+                              ? 1000
+                              : 999 + static_cast<int>(line);
+        loader.add(line, res);
+    }
+    loader.finish();
+
+    EXPECT_EQ(loader.inserted(), lines - 1);
+    ASSERT_EQ(loader.rejected().size(), 1u);
+    EXPECT_EQ(loader.rejected()[0].line, overlapping);
+    EXPECT_FALSE(loader.rejected()[0].error.empty());
+
+    std::size_t loaded = 0;
+    for (const BulkLoader::IdRange& range : loader.ids()) {
+        ASSERT_LE(range.first, range.last);
+        loaded += static_cast<std::size_t>(range.last - range.first + 1);
+    }
+    EXPECT_EQ(loaded, lines - 1);
+    EXPECT_EQ(db.getReservationById(*conn, loader.ids().front().first)
+                  .room_number,
+              1000);
+    EXPECT_EQ(db.getReservationById(*conn, loader.ids().back().last)
+                  .room_number,
+              999 + static_cast<int>(lines));
+
+    cleanupTestData();
+}
+
+TEST(PostgresDB, SearchAndOverlapQueries) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    auto conn = db.getConnectionPool()->acquire();
+
+    // The constructor left the search indexes in place
+    {
+        pqxx::work txn(*conn);
+        auto result = txn.exec(R"(
+            SELECT count(*) FROM pg_indexes
+            WHERE tablename = 'reservations'
+              AND indexname IN ('reservations_room_dates_idx',
+                                'reservations_check_in_id_idx',
+                                'reservations_status_dates_idx'))");
+        EXPECT_EQ(result[0][0].as<int>(), 3);
+        txn.commit();
+    }
+
+    // Room 179: Feb 15-18 confirmed, Mar 1-4 pending
+    Reservation first = createBaseReservation();
+    first.room_number = 179;
+    Reservation second = createBaseReservation();
+    second.room_number = 179;
+    second.check_in_date = "2026-03-01";
+    second.check_out_date = "2026-03-04";
+    second.reservation_status = "pending";
+    int firstId = db.insertReservation(*conn, first);
+    int secondId = db.insertReservation(*conn, second);
+    ASSERT_NE(firstId, -1);
+    ASSERT_NE(secondId, -1);
+
+    ReservationSearch search;
+    search.roomNumber = 179;
+    auto found = db.searchReservations(*conn, search);
+    ASSERT_EQ(found.size(), 2u);
+    EXPECT_EQ(found[0].id, firstId);
+    EXPECT_EQ(found[1].id, secondId);
+    EXPECT_EQ(found[1].reservation.check_in_date, "2026-03-01");
+
+    search.from = "2026-02-18";
+    search.to = "2026-02-28";
+    found = db.searchReservations(*conn, search);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].id, firstId);
+
+    search = ReservationSearch();
+    search.roomNumber = 179;
+    search.status = "pending";
+    search.limit = 1;
+    found = db.searchReservations(*conn, search);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].id, secondId);
+    search.limit = PostgresDB::kMaxSearchLimit + 1;
+    EXPECT_THROW(db.searchReservations(*conn, search), std::invalid_argument);
+
+    EXPECT_EQ(db.overlappingReservations(*conn, 179, "2026-02-10",
+                                         "2026-03-01"),
+              (std::vector<int>{firstId, secondId}));
+    EXPECT_TRUE(
+        db.overlappingReservations(*conn, 179, "2026-02-19", "2026-02-28")
+            .empty());
+    cleanupTestData();
+}
+
+// Walking a room's reservations page by page visits each one once, in
+// order, whatever the page size
+TEST(PostgresDB, KeysetPagination) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    auto conn = db.getConnectionPool()->acquire();
+
+    // Inserted out of date order: ID order and date order differ
+    std::vector<int> ids;
+    for (const char* checkIn : {"2026-03-10", "2026-02-01", "2026-04-05"}) {
+        Reservation res = createBaseReservation();
+        res.room_number = 171;
+        res.check_in_date = checkIn;
+        res.check_out_date = std::string(checkIn, 8) + "28";
+        ids.push_back(db.insertReservation(*conn, res));
+        ASSERT_NE(ids.back(), -1);
+    }
+
+    auto walk = [&](ReservationOrder order, std::size_t pageSize) {
+        ReservationSearch search;
+        search.roomNumber = 171;
+        search.order = order;
+        search.limit = pageSize;
+        std::vector<int> visited;
+        int pages = 0;
+        do {
+            auto next = db.visitReservations(
+                *conn, search, [&visited](int id, const Reservation&) {
+                    visited.push_back(id);
+                });
+            search.after = next;
+            pages++;
+        } while (search.after && pages < 10);
+        return visited;
+    };
+    std::vector<int> byDate = {ids[1], ids[0], ids[2]};
+    EXPECT_EQ(walk(ReservationOrder::Id, 1), ids);
+    EXPECT_EQ(walk(ReservationOrder::Id, 3), ids);
+    EXPECT_EQ(walk(ReservationOrder::CheckInDate, 1), byDate);
+    EXPECT_EQ(walk(ReservationOrder::CheckInDate, 2), byDate);
+    EXPECT_EQ(walk(ReservationOrder::CheckInDate, 100), byDate);
+
+    // A full last page says so: no cursor to an empty page
+    ReservationSearch search;
+    search.roomNumber = 171;
+    search.limit = 3;
+    EXPECT_FALSE(db.visitReservations(*conn, search,
+                                      [](int, const Reservation&) {})
+                     .has_value());
+    cleanupTestData();
+}
+
+// An export is read in pieces of whole lines; NDJSON survives COPY's own
+// escaping, and an export dropped halfway leaves a usable pool
+TEST(PostgresDB, ExportStreamsCopyOutput) {
+    cleanupTestData();
+    ConfigManager config(".env");
+    PostgresDB db(config);
+    ConnectionPool* pool = db.getConnectionPool();
+
+    const std::string requests = "Say \"hi\" \\ then\na new line";
+    std::vector<int> ids;
+    {
+        auto conn = pool->acquire();
+        for (const char* checkIn : {"2026-02-01", "2026-03-01", "2026-04-01"}) {
+            Reservation res = createBaseReservation();
+            res.room_number = 166;
+            res.check_in_date = checkIn;
+            res.check_out_date = std::string(checkIn, 8) + "20";
+            res.special_requests = requests;
+            ids.push_back(db.insertReservation(*conn, res));
+            ASSERT_NE(ids.back(), -1);
+        }
+    }
+    ReservationSearch search;
+    search.roomNumber = 166;
+
+    auto ndjson = db.exportReservations(pool->acquire(), search,
+                                        ExportFormat::Ndjson);
+    std::vector<std::string> pieces;
+    std::string piece;
+    bool more = true;
+    while (more) {
+        more = ndjson->read(piece, 1);
+        if (!piece.empty()) {
+            pieces.push_back(piece);
+        }
+    }
+    ASSERT_EQ(pieces.size(), ids.size());
+    for (std::size_t i = 0; i < ids.size(); i++) {
+        ASSERT_EQ(pieces[i].back(), '\n');
+        boost::json::object row = boost::json::parse(pieces[i]).as_object();
+        EXPECT_EQ(row.at("id").as_int64(), ids[i]);
+        EXPECT_EQ(row.at("special_requests").as_string(), requests);
+    }
+    ndjson.reset();
+
+    auto csv = db.exportReservations(pool->acquire(), search,
+                                     ExportFormat::Csv);
+    std::string all;
+    while (csv->read(piece, 1 << 20)) {
+        all += piece;
+    }
+    all += piece;
+    csv.reset();
+    // Header, then the rows: the newline in special_requests is quoted
+    EXPECT_EQ(all.rfind("id,guest_name,", 0), 0u);
+    EXPECT_EQ(std::count(all.begin(), all.end(), '\n'), 1 + 2 * 3);
+
+    auto dropped = db.exportReservations(pool->acquire(), search,
+                                         ExportFormat::Csv);
+    dropped->read(piece, 1);
+    dropped.reset();
+    auto conn = pool->acquire();
+    EXPECT_EQ(db.searchReservations(*conn, search).size(), ids.size());
+    cleanupTestData();
+}
+
+// Writes .env plus extraSettings to filename, for tests needing other keys
+static void writeEnvWith(const std::string& filename,
+                         const std::string& extraSettings) {
+    std::ifstream base(".env");
+    std::ofstream file(filename);
+    file << base.rdbuf() << "\n" << extraSettings;
+}
+
+// The configured database doubles as its own replica: routing is seen in
+// the counters, the data is the same either way
+TEST(PostgresDB, ReadReplicaRouting) {
+    cleanupTestData();
+    ConfigManager primaryConfig(".env");
+    writeEnvWith(".env.replica_test",
+                 "DB_READ_HOST=" + primaryConfig.get("DB_HOST") +
+                     "\nDB_READ_YOUR_WRITES_MS=60000\n");
+    ConfigManager config(".env.replica_test");
+    std::remove(".env.replica_test");
+    PostgresDB db(config);
+    ASSERT_NE(db.getReadPool(), nullptr);
+
+    Reservation res = createBaseReservation();
+    res.room_number = 177;
+    int id = db.insertReservation(res);
+    ASSERT_NE(id, -1);
+    auto read = [&db, id](pqxx::connection& conn) {
+        return db.getReservationById(conn, id);
+    };
+
+    EXPECT_EQ(db.withReadConnection("10.0.0.1", read).room_number, 177);
+    EXPECT_EQ(db.withReadConnection("", read).room_number, 177);
+    db.noteWrite("10.0.0.1");
+    EXPECT_EQ(db.withReadConnection("10.0.0.1", read).room_number, 177);
+    EXPECT_EQ(db.withReadConnection("10.0.0.2", read).room_number, 177);
+
+    ReadRoutingStats stats = db.readRoutingStats();
+    EXPECT_EQ(stats.replicaReads, 3u);
+    EXPECT_EQ(stats.primaryReads, 1u) << "The writer reads its own write";
+    EXPECT_EQ(stats.fallbacks, 0u);
+    cleanupTestData();
+}
+
+// An unreachable replica neither stops startup nor fails reads; lookup
+// errors still reach the caller
+TEST(PostgresDB, ReadReplicaFallsBackToPrimary) {
+    cleanupTestData();
+    writeEnvWith(".env.replica_test",
+                 "DB_READ_HOST=127.0.0.1\nDB_READ_PORT=1\n");
+    ConfigManager config(".env.replica_test");
+    std::remove(".env.replica_test");
+    PostgresDB db(config);
+    ASSERT_NE(db.getReadPool(), nullptr);
+
+    Reservation res = createBaseReservation();
+    res.room_number = 178;
+    int id = db.insertReservation(res);
+    ASSERT_NE(id, -1);
+
+    Reservation found = db.withReadConnection(
+        "10.0.0.1", [&db, id](pqxx::connection& conn) {
+            return db.getReservationById(conn, id);
+        });
+    EXPECT_EQ(found.room_number, 178);
+    EXPECT_THROW(db.withReadConnection("10.0.0.1",
+                                       [&db](pqxx::connection& conn) {
+                                           return db.getReservationById(
+                                               conn, 999999);
+                                       }),
+                 ReservationNotFound);
+
+    ReadRoutingStats stats = db.readRoutingStats();
+    EXPECT_EQ(stats.replicaReads, 0u);
+    EXPECT_EQ(stats.fallbacks, 2u);
+    cleanupTestData();
+}
+
 // Test data persistence
 TEST(PostgresDB, DataPersistence) {
     cleanupTestData();
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "../src/HTTP/QueryString.hpp"
+
+TEST(QueryString, ReadsDecodedParameters) {
+    QueryString query(
+        "/application/reservations?room_number=12&status=checked+in"
+        "&note=a%2Fb%3dc&flag&&room_number=13");
+
+    EXPECT_EQ(query.get("room_number"), "12") << "The first one wins";
+    EXPECT_EQ(query.get("status"), "checked in");
+    EXPECT_EQ(query.get("note"), "a/b=c");
+    EXPECT_EQ(query.get("flag"), "");
+    EXPECT_FALSE(query.get("from").has_value());
+    EXPECT_EQ(query.all().size(), 5u);
+}
+
+TEST(QueryString, HandlesTargetsWithoutQuery) {
+    EXPECT_TRUE(QueryString("/application/reservations").all().empty());
+    EXPECT_TRUE(QueryString("/application/reservations?").all().empty());
+}
+
+TEST(QueryString, RejectsMalformedEscapes) {
+    EXPECT_THROW(QueryString("/r?a=%2"), std::invalid_argument);
+    EXPECT_THROW(QueryString("/r?a=%zz"), std::invalid_argument);
+    EXPECT_THROW(QueryString("/r?a=%"), std::invalid_argument);
+}
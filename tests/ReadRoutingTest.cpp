@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "../src/DataBase/ReadRouting.hpp"
+
+TEST(RecentWriters, RemembersWritersForTheWindow) {
+    RecentWriters writers(std::chrono::milliseconds(50));
+    writers.noteWrite("10.0.0.1");
+
+    EXPECT_TRUE(writers.wroteRecently("10.0.0.1"));
+    EXPECT_FALSE(writers.wroteRecently("10.0.0.2"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_FALSE(writers.wroteRecently("10.0.0.1"));
+
+    // A new write restarts the window, after pruning the expired entry
+    writers.noteWrite("10.0.0.1");
+    EXPECT_TRUE(writers.wroteRecently("10.0.0.1"));
+}
+
+TEST(RecentWriters, IgnoresUnknownClientsAndZeroWindow) {
+    RecentWriters writers(std::chrono::milliseconds(1000));
+    writers.noteWrite("");
+    EXPECT_FALSE(writers.wroteRecently(""));
+
+    RecentWriters disabled(std::chrono::milliseconds(0));
+    disabled.noteWrite("10.0.0.1");
+    EXPECT_FALSE(disabled.wroteRecently("10.0.0.1"));
+}
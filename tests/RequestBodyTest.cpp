@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <boost/asio.hpp>
+#include <string>
+
+#include "../src/HTTP/RequestBody.hpp"
+
+namespace net = boost::asio;
+
+// Feeds raw to a request parser chunkSize bytes at a time, the way a slow
+// socket would deliver it, and returns the parsed request
+static http::request<RequestBody> parseInChunks(
+    const std::string& raw, std::size_t chunkSize,
+    JsonParseContext* context = nullptr) {
+    http::request_parser<RequestBody> parser;
+    parser.get().body().useContext(context);
+    std::string pending;
+    for (std::size_t offset = 0; offset < raw.size(); offset += chunkSize) {
+        pending.append(raw, offset, chunkSize);
+        std::size_t used = 0;
+        do {
+            beast::error_code ec;
+            used = parser.put(net::buffer(pending), ec);
+            if (ec == http::error::need_more) {
+                ec = {};
+            }
+            EXPECT_FALSE(ec) << ec.message();
+            pending.erase(0, used);
+        } while (used > 0 && !pending.empty() && !parser.is_done());
+    }
+    EXPECT_TRUE(parser.is_done());
+    return parser.release();
+}
+
+static std::string rawPost(const std::string& contentType,
+                           const std::string& body) {
+    return "POST /application/reservation HTTP/1.1\r\nHost: localhost\r\n"
+           "Content-Type: " +
+           contentType + "\r\nContent-Length: " +
+           std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+TEST(RequestBody, JsonIsParsedWhileReceived) {
+    auto request = parseInChunks(
+        rawPost("application/json; charset=utf-8",
+                R"({"guest_name":"Ana","room_number":12,"paid":true})"),
+        7);
+    const auto& body = request.body();
+    ASSERT_TRUE(body.isJson());
+    EXPECT_FALSE(body.jsonError());
+    EXPECT_TRUE(body.text().empty());
+    EXPECT_EQ(body.size(), 49u);
+    EXPECT_EQ(body.json().as_object().at("guest_name").as_string(), "Ana");
+    EXPECT_EQ(body.json().as_object().at("room_number").as_int64(), 12);
+}
+
+TEST(RequestBody, JsonSyntaxErrorIsRecorded) {
+    auto request =
+        parseInChunks(rawPost("application/json", R"({"guest_name": )"), 4);
+    const auto& body = request.body();
+    EXPECT_TRUE(body.isJson());
+    EXPECT_TRUE(body.jsonError());
+    EXPECT_TRUE(body.json().is_null());
+
+    auto garbage = parseInChunks(rawPost("application/json", "{oops}"), 3);
+    EXPECT_TRUE(garbage.body().jsonError());
+}
+
+TEST(RequestBody, OtherContentTypesKeepText) {
+    auto request = parseInChunks(rawPost("text/plain", "hello world"), 5);
+    EXPECT_FALSE(request.body().isJson());
+    EXPECT_EQ(request.body().text(), "hello world");
+}
+
+TEST(RequestBody, DetectsJsonContentType) {
+    EXPECT_TRUE(RequestBody::isJsonContentType("application/json"));
+    EXPECT_TRUE(RequestBody::isJsonContentType("Application/JSON"));
+    EXPECT_TRUE(
+        RequestBody::isJsonContentType("application/json ; charset=utf-8"));
+    EXPECT_FALSE(RequestBody::isJsonContentType("text/plain"));
+    EXPECT_FALSE(RequestBody::isJsonContentType(""));
+}
+
+TEST(RequestBody, SessionContextIsReusedAcrossRequests) {
+    JsonParseContext context;
+    for (int i = 0; i < 3; i++) {
+        context.reset();
+        std::string json = R"({"room_number":)" + std::to_string(i) + "}";
+        auto request =
+            parseInChunks(rawPost("application/json", json), 5, &context);
+        ASSERT_FALSE(request.body().jsonError());
+        EXPECT_EQ(
+            request.body().json().as_object().at("room_number").as_int64(),
+            i);
+    }
+}
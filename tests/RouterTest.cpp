@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "../src/HTTP/Router.hpp"
+#include "AllocationCounter.hpp"
+
+namespace {
+
+// Handlers are plain ids here; RequestHandler uses member function pointers
+constexpr Router<int, 6> testRouter{{{
+    {http::verb::post, "/application/reservation", 1},
+    {http::verb::get, "/application/reservation/{id:int}", 2},
+    {http::verb::delete_, "/application/reservation/{id:int}", 3},
+    {http::verb::get, "/application/reservation/latest", 4},
+    {http::verb::get, "/guests/{name}/reservations/{id:int}", 5},
+    {http::verb::get, "/", 6},
+}}};
+
+}  // namespace
+
+TEST(Router, MatchesLiteralRoute) {
+    auto route =
+        testRouter.match(http::verb::post, "/application/reservation");
+    EXPECT_EQ(route.status, RouteStatus::Matched);
+    EXPECT_EQ(route.handler, 1);
+    EXPECT_EQ(route.params.size(), 0u);
+
+    auto root = testRouter.match(http::verb::get, "/");
+    EXPECT_EQ(root.status, RouteStatus::Matched);
+    EXPECT_EQ(root.handler, 6);
+}
+
+TEST(Router, ExtractsTypedParameters) {
+    auto route =
+        testRouter.match(http::verb::get, "/application/reservation/42");
+    ASSERT_EQ(route.status, RouteStatus::Matched);
+    EXPECT_EQ(route.handler, 2);
+    ASSERT_EQ(route.params.size(), 1u);
+    EXPECT_EQ(route.params[0].name, "id");
+    EXPECT_EQ(route.params[0].number, 42);
+
+    auto nested =
+        testRouter.match(http::verb::get, "/guests/ana/reservations/7?x=1");
+    ASSERT_EQ(nested.status, RouteStatus::Matched);
+    EXPECT_EQ(nested.handler, 5);
+    ASSERT_EQ(nested.params.size(), 2u);
+    EXPECT_EQ(nested.params.find("name")->text, "ana");
+    EXPECT_EQ(nested.params.find("id")->number, 7);
+    EXPECT_EQ(nested.params.find("missing"), nullptr);
+}
+
+TEST(Router, LiteralSegmentWinsOverParameter) {
+    auto route =
+        testRouter.match(http::verb::get, "/application/reservation/latest");
+    EXPECT_EQ(route.status, RouteStatus::Matched);
+    EXPECT_EQ(route.handler, 4);
+}
+
+TEST(Router, RejectsInvalidParameter) {
+    for (const char* target :
+         {"/application/reservation/abc", "/application/reservation/12x",
+          "/application/reservation/",
+          "/application/reservation/99999999999"}) {
+        auto route = testRouter.match(http::verb::delete_, target);
+        EXPECT_EQ(route.status, RouteStatus::InvalidParameter) << target;
+    }
+}
+
+TEST(Router, UnknownPathOrVerbIsNotFound) {
+    EXPECT_EQ(testRouter.match(http::verb::get, "/invalid").status,
+              RouteStatus::NotFound);
+    EXPECT_EQ(testRouter.match(http::verb::put, "/application/reservation/1")
+                  .status,
+              RouteStatus::NotFound);
+    EXPECT_EQ(
+        testRouter.match(http::verb::get, "/application/reservation/1/x")
+            .status,
+        RouteStatus::NotFound);
+    EXPECT_EQ(testRouter.match(http::verb::get, "application").status,
+              RouteStatus::NotFound);
+}
+
+TEST(Router, MatchingDoesNotAllocate) {
+    auto before = allocationsOnThisThread();
+    int matched = 0;
+    for (int i = 0; i < 1000; i++) {
+        auto route = testRouter.match(http::verb::get,
+                                      "/guests/ana/reservations/7?x=1");
+        matched += route.status == RouteStatus::Matched ? 1 : 0;
+    }
+    EXPECT_EQ(allocationsOnThisThread() - before, 0u);
+    EXPECT_EQ(matched, 1000);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/Utils/ShardedLruCache.hpp"
+
+using Cache = ShardedLruCache<int, std::string>;
+
+TEST(ShardedLruCache, EvictsLeastRecentlyUsed) {
+    Cache cache(2, std::chrono::milliseconds(0), 1);
+    cache.put(1, "one");
+    cache.put(2, "two");
+
+    std::string value;
+    ASSERT_TRUE(cache.get(1, value));
+    EXPECT_EQ(value, "one");
+    // 2 is now the least recently used one
+    cache.put(3, "three");
+    EXPECT_FALSE(cache.get(2, value));
+    EXPECT_TRUE(cache.get(1, value));
+    EXPECT_TRUE(cache.get(3, value));
+    EXPECT_EQ(value, "three");
+
+    Cache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(stats.capacity, 2u);
+}
+
+TEST(ShardedLruCache, EntriesExpireAfterTtl) {
+    Cache cache(8, std::chrono::milliseconds(20));
+    cache.put(1, "one");
+    std::string value;
+    EXPECT_TRUE(cache.get(1, value));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(cache.get(1, value));
+    EXPECT_EQ(cache.stats().expirations, 1u);
+    EXPECT_EQ(cache.stats().size, 0u);
+}
+
+// A value loaded before an invalidation is not cached after it
+TEST(ShardedLruCache, EraseDropsConcurrentLoad) {
+    Cache cache(8, std::chrono::milliseconds(0));
+    cache.put(1, "old");
+
+    std::uint64_t epoch = cache.epoch(1);
+    cache.erase(1);
+    EXPECT_FALSE(cache.putIfUnchanged(1, "old", epoch));
+    std::string value;
+    EXPECT_FALSE(cache.get(1, value));
+
+    EXPECT_TRUE(cache.putIfUnchanged(1, "new", cache.epoch(1)));
+    ASSERT_TRUE(cache.get(1, value));
+    EXPECT_EQ(value, "new");
+    EXPECT_EQ(cache.stats().invalidations, 1u);
+}
+
+// A lagging source may return the erased version for settle after the
+// erase; keys not erased recently are still cached from it
+TEST(ShardedLruCache, LaggingStoresWaitForSettle) {
+    Cache cache(8, std::chrono::milliseconds(0), 1,
+                std::chrono::milliseconds(50));
+    cache.erase(1);
+    EXPECT_FALSE(cache.putIfUnchanged(1, "old", cache.epoch(1), true));
+    EXPECT_TRUE(cache.putIfUnchanged(2, "two", cache.epoch(2), true));
+    // Non-lagging values do not wait
+    EXPECT_TRUE(cache.putIfUnchanged(1, "new", cache.epoch(1)));
+    cache.erase(1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_TRUE(cache.putIfUnchanged(1, "new", cache.epoch(1), true));
+    std::string value;
+    ASSERT_TRUE(cache.get(1, value));
+    EXPECT_EQ(value, "new");
+}
+
+TEST(ShardedLruCache, ConcurrentReadersAndWriters) {
+    Cache cache(64, std::chrono::milliseconds(0), 8);
+    constexpr int kThreads = 8;
+    constexpr int kOperations = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&cache, t]() {
+            std::string value;
+            for (int i = 0; i < kOperations; i++) {
+                int key = (i * 7 + t) % 128;
+                if (!cache.get(key, value)) {
+                    cache.putIfUnchanged(key, std::to_string(key),
+                                         cache.epoch(key));
+                } else if (value != std::to_string(key)) {
+                    ADD_FAILURE() << "Key " << key << " holds " << value;
+                }
+                if (i % 100 == 0) {
+                    cache.erase(key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Cache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses,
+              static_cast<std::uint64_t>(kThreads * kOperations));
+    EXPECT_LE(stats.size, stats.capacity);
+}
+
+TEST(ShardedLruCache, RejectsInvalidSettings) {
+    EXPECT_THROW(Cache(0, std::chrono::milliseconds(0)),
+                 std::invalid_argument);
+    EXPECT_THROW(Cache(8, std::chrono::milliseconds(0), 0),
+                 std::invalid_argument);
+    EXPECT_THROW(Cache(8, std::chrono::milliseconds(-1)),
+                 std::invalid_argument);
+    EXPECT_THROW(Cache(8, std::chrono::milliseconds(0), 1,
+                       std::chrono::milliseconds(-1)),
+                 std::invalid_argument);
+}
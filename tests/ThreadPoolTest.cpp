@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include "../src/Utils/ThreadPool.hpp"
+
+// Task that blocks its worker until release is fulfilled
+class GateTask : public Task {
+   public:
+    GateTask(std::shared_future<void> release, std::atomic<int>& started)
+        : release(std::move(release)), started(started) {}
+
+    void execute() override {
+        started++;
+        release.wait();
+    }
+
+   private:
+    std::shared_future<void> release;
+    std::atomic<int>& started;
+};
+
+TEST(ThreadPool, TryEnqueueRefusesWhenQueueFull) {
+    std::promise<void> gate;
+    std::shared_future<void> release = gate.get_future().share();
+    std::atomic<int> started{0};
+    {
+        ThreadPool pool(1, 1);
+        EXPECT_EQ(pool.queueCapacity(), 1u);
+
+        // First task occupies the only worker
+        auto running = std::make_unique<GateTask>(release, started);
+        ASSERT_TRUE(pool.tryEnqueueTask(running));
+        EXPECT_EQ(running, nullptr);
+        while (started.load() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // Second one waits in the queue, third one is handed back
+        auto waiting = std::make_unique<GateTask>(release, started);
+        ASSERT_TRUE(pool.tryEnqueueTask(waiting));
+        EXPECT_EQ(pool.queuedTasks(), 1u);
+        auto refused = std::make_unique<GateTask>(release, started);
+        EXPECT_FALSE(pool.tryEnqueueTask(refused));
+        EXPECT_NE(refused, nullptr);
+
+        gate.set_value();
+    }
+    EXPECT_EQ(started.load(), 2);
+}
+
+TEST(ThreadPool, UnboundedQueueAcceptsEverything) {
+    std::promise<void> gate;
+    std::shared_future<void> release = gate.get_future().share();
+    std::atomic<int> started{0};
+    {
+        ThreadPool pool(1);
+        EXPECT_EQ(pool.queueCapacity(), 0u);
+        for (int i = 0; i < 16; i++) {
+            auto task = std::make_unique<GateTask>(release, started);
+            EXPECT_TRUE(pool.tryEnqueueTask(task));
+        }
+        gate.set_value();
+    }
+    EXPECT_EQ(started.load(), 16);
+}